@@ -4,47 +4,121 @@
  * Copyright: 2024, theonelog
  * 
  * Description: Reads the file and counts the amount of words in a file fed thru the command line.
+ * With -j N, the file is split into N byte ranges that are counted on N threads at once.
  */
 #include <stdio.h> //Libraries required for the program to function
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "tokens.h" //maps the file and counts its words
 
-#define MAX_WORD_LENGTH 30  //The max length of a word
+/*
+* This is the struct for one byte range of the file that a thread counts.
+* space is whether the byte just before the range is whitespace, which is true for the first range since nothing comes before it.
+*/
+struct chunk{
+    char *data; //the start of the range
+    size_t length; //the # of bytes in the range
+    bool space; //whether the byte before the range is whitespace
+    long count; //the # of words that start in the range
+};
+
+/*
+* Counts the words that start in the chunk passed in as arg. This is the function that each thread runs.
+*/
+static void *countChunk(void *arg){
+    struct chunk *cp = arg;
+    cp -> count = countWords(cp -> data, cp -> length, cp -> space);
+    return NULL;
+}
 
 int main(int argc, char* argv[]){
 
-    FILE *pFile; //the pointer to the file
-    char word[MAX_WORD_LENGTH]; //the buffer that holds each word
-    int wordCnt = 0; //the counter variable for the # of words
+    TOKENS *tokens; //the words of the file
+    char *data; //the contents of the file
+    size_t length; //the # of bytes in the file
+    long wordCnt = 0; //the counter variable for the # of words
+    int threads = 1; //the # of threads to count with
+    struct chunk *chunks; //the range each thread counts
+    pthread_t *ids; //the id of each thread
 
     /*  
-    * Checks if there is a second argument
+    * Checks for the -j option and then if there is a second argument
     */
 
+    if(argc == 4 && strcmp(argv[1], "-j") == 0){
+        threads = atoi(argv[2]);
+        if(threads < 1){
+            fprintf(stderr, "invalid thread count\n");
+            exit(EXIT_FAILURE);
+        }
+        argv[1] = argv[3];
+        argc -= 2;
+    }
+
     if(argc != 2){
         fprintf(stderr, "missing file path\n");
         exit(EXIT_FAILURE);
     }
 
-    pFile = fopen(argv[1], "r"); //assigns the pFile pointer to the file directory
+    tokens = openTokens(argv[1]); //maps the file into memory
 
     /*
     * Checks if the the file pointer successfully references a file name
     */
-    if (pFile == NULL){
+    if (tokens == NULL){
         fprintf(stderr, "file path not valid\n");
         exit(EXIT_FAILURE);
     }
     /*
     * Counts the amount of words in the file
+    * Instead of splitting out each word, countWords counts the places where a non-whitespace character follows whitespace
+    (or the start of the file), checking 64 bytes at a time with SIMD instructions. A long count is used since a big enough file
+    has more words than an int can hold.
+    * The file is cut into one range per thread. A word that straddles a cut is only counted by the range it starts in, since
+    each range is told whether the byte before it is whitespace, so the total is exactly the same as counting the whole file at once.
     */
-    while(fscanf(pFile, "%s", word) == 1){
-        wordCnt++;
+    data = tokenData(tokens, &length);
+    if((size_t) threads > length){
+        threads = length > 0 ? length : 1;
+    }
+
+    chunks = malloc(sizeof(struct chunk) * threads);
+    ids = malloc(sizeof(pthread_t) * threads);
+    if(chunks == NULL || ids == NULL){
+        fprintf(stderr, "out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for(int i = 0; i < threads; i++){
+        size_t start = length / threads * i;
+        size_t end = i == threads - 1 ? length : length / threads * (i + 1);
+        chunks[i].data = data + start;
+        chunks[i].length = end - start;
+        chunks[i].space = start == 0 || isspace((unsigned char) data[start - 1]);
+    }
+
+    for(int i = 1; i < threads; i++){
+        if(pthread_create(&ids[i], NULL, countChunk, &chunks[i]) != 0){
+            fprintf(stderr, "cannot create thread\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    countChunk(&chunks[0]); //the main thread counts the first range itself
+
+    wordCnt = chunks[0].count;
+    for(int i = 1; i < threads; i++){
+        pthread_join(ids[i], NULL);
+        wordCnt += chunks[i].count;
     }
 
-    fclose(pFile); //closes the file
+    free(chunks);
+    free(ids);
+    closeTokens(tokens); //unmaps the file
 
-    printf("Word count: %d \n", wordCnt); //prints out the final word count
+    printf("Word count: %ld \n", wordCnt); //prints out the final word count
 
     exit(0); //exits the program
-}
\ No newline at end of file
+}
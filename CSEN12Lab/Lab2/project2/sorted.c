@@ -4,18 +4,48 @@
 * Last Updated: 10/9/2024
 * Description: This file an implementation of the Set ADT using a sorted array. This can be used with the parity.c and unique.c files to run
 a variety of comparissons. The search algorithm used in this implementation is a binary search.
+* The unused part of the data array is kept as a gap wherever the last insert or removal happened, like the gap buffer of a text editor.
+Inserting next to the previous insert, which is what happens when the input is already sorted, then only has to move the gap by a few slots.
+* Once there have been more lookups since the last insert than there are elements, the set also builds a read-only index for lookups. The
+first 8 bytes of each element are stored as an integer in Eytzinger order, which is the order of a breadth first walk of the binary search
+tree, so that the first few levels of every search share a few cache lines and the later ones can be prefetched. Adding a new element
+throws the index away again.
 */
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include "set.h"
+#include "arena.h"
 #include <assert.h>
 #include <stdbool.h>
+#ifdef SETSTATS
+#define STAT(x) (x)
+#else
+#define STAT(x)
+#endif
+#define MIN_INDEX 64 //the fewest elements worth building an index for
+#define LINE 64 //the # of bytes in a cache line
 
+/*
+* This is the set struct for a sorted array implementation. The elements are in sorted order in data, except that the length - count
+unused slots form a gap that starts at index gap.
+* While there is an index, the gap is at the end and stays there. indexed is the # of positions in the index, keys and slots are the
+prefix and the position of the element at each node of the tree starting at 1, and dead marks the positions removed since the index was built.
+*/
 struct set{
     int count;
     int length;
+    int gap;
     char **data;
+    ARENA *strings;
+    int lookups;
+    int indexed;
+    unsigned long long *keys;
+    int *slots;
+    bool *dead;
+#ifdef SETSTATS
+    struct setstats stats;
+#endif
 };
 /*
 * Big-O: O(1)
@@ -30,9 +60,54 @@ SET *createSet(int maxElts){
     sp = malloc(sizeof(SET));
     assert(sp != NULL);
     sp -> data = malloc(sizeof(char *) * maxElts);
+    sp -> strings = createArena();
     sp -> length = maxElts;
     sp -> count = 0;
+    sp -> gap = 0;
+    sp -> lookups = 0;
+    sp -> indexed = 0;
+    STAT(memset(&sp -> stats, 0, sizeof(sp -> stats)));
+    return sp;
+}
+/*
+* Big-O: O(1)
+*
+* This function returns the index in the data array of the element at position i in sorted order. The elements before the gap are
+where they belong and the ones after it are moved right by the size of the gap.
+*/
+static inline int at(SET *sp, int i){
+    return i < sp -> gap ? i : i + sp -> length - sp -> count;
+}
+/*
+* Big-O: O(n)
+*
+* This function moves the gap so that it starts at position i. The elements between the old and new place of the gap are moved across it
+with a single memmove of their pointers, so moving the gap a short way is cheap.
+*/
+static void moveGap(SET *sp, int i){
+    int size = sp -> length - sp -> count;
+    if(i < sp -> gap){
+        memmove(sp -> data + i + size, sp -> data + i, sizeof(char *) * (sp -> gap - i));
+    }
+    else if(i > sp -> gap){
+        memmove(sp -> data + sp -> gap, sp -> data + sp -> gap + size, sizeof(char *) * (i - sp -> gap));
+    }
+    sp -> gap = i;
+}
+#ifdef SETSTATS
+/*
+* Big-O: O(1)
+*
+* This function counts one search that made probes string compares, adding it to the histogram and the longest probe length.
+*/
+static void record(SET *sp, int probes){
+    sp -> stats.searches++;
+    sp -> stats.probes[probes < SETSTATS_BUCKETS ? probes : SETSTATS_BUCKETS - 1]++;
+    if(probes > sp -> stats.maxProbe){
+        sp -> stats.maxProbe = probes;
+    }
 }
+#endif
 /*
 * Big-O: O(log n)
 *
@@ -44,37 +119,184 @@ SET *createSet(int maxElts){
 * This repeats until the value at index mid is equal to the element or when the lo value is higher than or equal to the hi value.'
 * If the value is found, the found boolean variable parameter is set to true and the index mid is returned.
 * If the value can't be found, then the lo variable is returned with the found boolean parameter being set to false.
+* strcmp is only called once per step and its result is used for both tests.
 */
 static int search(SET *sp, char *elt, bool *found){
     int lo = 0;
     int hi = (sp->count - 1);
-    int mid; 
+    int mid, cmp; 
+#ifdef SETSTATS
+    long before = sp -> stats.compares;
+#endif
     while(lo <= hi){
         mid = (hi + lo)/2;
-        if(strcmp(sp->data[mid], elt) == 0){
+        cmp = strcmp(sp->data[at(sp, mid)], elt);
+        STAT(sp -> stats.compares++);
+        if(cmp == 0){
+            STAT(record(sp, sp -> stats.compares - before));
             *found = true;
             return mid;
         }
-        else if(strcmp(sp->data[mid], elt) < 0){
+        else if(cmp < 0){
             lo = mid + 1;
         }
         else{
             hi = mid - 1;
         }
     }
+    STAT(record(sp, sp -> stats.compares - before));
     *found = false;
     return lo;
 }   
 /*
+* Big-O: O(1)
+*
+* This function returns the first 8 bytes of the string s as an integer, with the first byte as the highest byte and null characters after
+the end of a shorter string. Comparing two prefixes as integers then gives the same order as strcmp, except that strings that start with
+the same 8 bytes have the same prefix.
+*/
+static unsigned long long prefix(char *s){
+    unsigned long long key = 0;
+    for(int i = 0; i < 8; i++){
+        key <<= 8;
+        if(*s != '\0'){
+            key |= (unsigned char) *s++;
+        }
+    }
+    return key;
+}
+/*
+* Big-O: O(n)
+*
+* This function fills in the subtree of the index rooted at node k with the elements in sorted order starting at position i, using an in-order
+walk so that every node ends up between its left and right children. It returns the position after the last element it used.
+*/
+static int fill(SET *sp, int k, int i){
+    if(k <= sp -> indexed){
+        i = fill(sp, 2 * k, i);
+        sp -> keys[k] = prefix(sp -> data[i]);
+        sp -> slots[k] = i++;
+        i = fill(sp, 2 * k + 1, i);
+    }
+    return i;
+}
+/*
+* Big-O: O(n)
+*
+* This function builds the index. It first moves the gap to the end so the position of every element is its index in data, and then
+fills in the tree. The keys are aligned to a cache line so that the 8 nodes that are 3 levels below a node are in a single line.
+*/
+static void buildIndex(SET *sp){
+    size_t size = (sizeof(unsigned long long) * (sp -> count + 1) + LINE - 1) / LINE * LINE;
+    moveGap(sp, sp -> count);
+    sp -> indexed = sp -> count;
+    sp -> keys = aligned_alloc(LINE, size);
+    sp -> slots = malloc(sizeof(int) * (sp -> count + 1));
+    sp -> dead = calloc(sp -> count, sizeof(bool));
+    assert(sp -> keys != NULL && sp -> slots != NULL && sp -> dead != NULL);
+    fill(sp, 1, 0);
+}
+/*
+* Big-O: O(n)
+*
+* This function throws the index away. The elements removed while there was an index are still in the data array, so the live ones are moved
+down over them and the gap is once again everything after the last element.
+*/
+static void dropIndex(SET *sp){
+    int n = 0;
+    for(int i = 0; i < sp -> indexed; i++){
+        if(!sp -> dead[i]){
+            sp -> data[n++] = sp -> data[i];
+        }
+    }
+    sp -> gap = n;
+    sp -> indexed = 0;
+    sp -> lookups = 0;
+    free(sp -> keys);
+    free(sp -> slots);
+    free(sp -> dead);
+}
+/*
+* Big-O: O(log n)
+*
+* This function returns the position of the first element in the index whose prefix is not less than key, or greater than key if upper is
+true. Each step goes to the left or right child of node k by adding the result of a comparison instead of branching on it, and prefetches
+the nodes 3 levels further down. When k falls off the bottom of the tree, the node where the search last went left is the one wanted, which
+is found by shifting off the trailing 1 bits of k along with one more bit.
+*/
+static inline int bound(SET *sp, unsigned long long key, bool upper){
+    int k = 1;
+    while(k <= sp -> indexed){
+        __builtin_prefetch(sp -> keys + 8 * k);
+        k = 2 * k + (upper ? sp -> keys[k] <= key : sp -> keys[k] < key);
+    }
+    k >>= __builtin_ffs(~k);
+    return k == 0 ? sp -> indexed : sp -> slots[k];
+}
+/*
+* Big-O: O(log n)
+*
+* This function searches the index for elt and returns its position the same way search does. The index narrows the search down to the run of
+elements that have the same prefix as elt, and then a binary search with strcmp finds elt in that run, so a long run of strings that
+start the same way does not have to be walked one at a time.
+* The elements removed since the index was built cannot be compared, since their strings were handed back to the arena. When the middle of the
+range is a removed one, the first element after it that is still there is compared instead, and if there is none the search goes left.
+best is the first element not less than elt found so far, and everything between hi and best has been removed.
+*/
+static int lookup(SET *sp, char *elt, bool *found){
+    unsigned long long key = prefix(elt);
+    int lo = bound(sp, key, false);
+    int hi = bound(sp, key, true);
+    int best = hi, mid, pos, cmp, bestCmp = 1;
+#ifdef SETSTATS
+    long before = sp -> stats.compares;
+#endif
+    while(lo < hi){
+        mid = lo + (hi - lo) / 2;
+        for(pos = mid; pos < hi && sp -> dead[pos]; pos++);
+        if(pos == hi){
+            hi = mid;
+            continue;
+        }
+        cmp = strcmp(sp -> data[pos], elt);
+        STAT(sp -> stats.compares++);
+        if(cmp < 0){
+            lo = pos + 1;
+        }
+        else{
+            hi = mid;
+            best = pos;
+            bestCmp = cmp;
+        }
+    }
+    STAT(record(sp, sp -> stats.compares - before));
+    *found = bestCmp == 0;
+    return best;
+}
+/*
+* Big-O: O(log n) amortized
+*
+* This function finds elt using the index if there is one and binary search if not. Once there have been more lookups since the last insert than
+there are elements, the index is built first. Building it is O(n), but since that only happens once every n lookups, it adds O(1) to each.
+*/
+static int locate(SET *sp, char *elt, bool *found){
+    if(sp -> indexed == 0 && ++sp -> lookups > sp -> count && sp -> count >= MIN_INDEX){
+        buildIndex(sp);
+    }
+    return sp -> indexed != 0 ? lookup(sp, elt, found) : search(sp, elt, found);
+}
+/*
 * Big-O: O(n)
 *
-* This function loops through the entire data array and deallocates any memory allocated to the elements of the data array and then nukes the data array pointer
-and the pointer to the entire set. The reason why it is O(n) is because it has a loop.
+* This function deallocates the arena that holds every string in the set all at once, and then nukes the data array pointer
+and the pointer to the entire set. Since the strings don't have to be freed one at a time there is no loop for them, so it is only O(n) when
+there is an index to throw away.
 */
 void destroySet(SET *sp){
-    for(int i = 0; i < sp -> count; i++){
-        free(sp -> data[i]);
+    if(sp -> indexed != 0){
+        dropIndex(sp);
     }
+    destroyArena(sp -> strings);
     free(sp -> data);
     free(sp);
 }
@@ -92,21 +314,28 @@ int numElements(SET *sp){
 *
 * This function takes in an element elt to add to the sorted array. First it checks if the element ever existed in the array at a point in time by using the search function.
 * It then assigns the return of the search function to location. If the exists boolean is false, then the function will continue to actually add the element.
-* Next, the function asserts that the count variable must be less than the length to prevent any seg faults. The function then shifts the array starting from the end of the array
-moving every element one to the right leaving an empty hole at the location variable index. 
-* The function then sets the element at index location to the element elt passed in as a parameter by duplicating its value and increments count by 1.
+* Next, the function asserts that the count variable must be less than the length to prevent any seg faults. The function then moves the gap
+to the location variable index, so the first slot of the gap is the empty hole where the element belongs.
+* The function then puts a copy of the element elt made in the set's arena in that slot, shrinking the gap from the front, and increments count by 1.
+* Only the pointers are moved, so each string is copied exactly once, when it is added. When the elements arrive in sorted order the gap is already
+in the right place and nothing has to move at all.
+* If there is an index and the element is new, the index is thrown away and the element searched for again, since its position changes
+once the removed elements are gone.
 */
 void addElement(SET *sp, char *elt){    
     bool exists;
-    int location = search(sp, elt, &exists);
+    int location = locate(sp, elt, &exists);
     assert(sp != NULL && elt != NULL);
 
     if(!exists){
         assert(sp -> count < sp -> length);
-        for(int i = (sp -> count - 1); i >= location; i--){
-            sp -> data[i + 1] = strdup(sp -> data[i]);
+        if(sp -> indexed != 0){
+            dropIndex(sp);
+            location = search(sp, elt, &exists);
         }
-        sp -> data[location] = strdup(elt);
+        sp -> lookups = 0;
+        moveGap(sp, location);
+        sp -> data[sp -> gap++] = arenaCopy(sp -> strings, elt);
         sp -> count++;
     }
 }
@@ -116,23 +345,32 @@ void addElement(SET *sp, char *elt){
 * This funciton takes in the parameter elt which is the element the user desires to be removed from the set. 
 * The function then checks if the element even exists in the sorted array. It returns the value returned by search into the loc variable.
 * Then the function checks if the exist boolean is true, meaning that the element is located in the sorted array. 
-* Once it confirms that, the function then iterates from the index stored in the loc variable to count - 1 and shiftes every element back 1, overriding the element at loc. 
-* Once it does that, it then sets the element at count - 1 to null and decrements count by 1 as well.
+* Once it confirms that, the removed string is handed back to the arena so that its space can be used by a later string of the same size.
+* The function then moves the gap to loc, which leaves the element at loc just after the end of the gap. Decrementing count grows the gap by one
+slot on that end, which takes the element out of the array without moving anything else.
+* If there is an index, the element is only marked as removed so the index stays valid, which is O(log n). Once more than half the positions
+in the index are removed ones, the index is thrown away so that lookups do not have to skip over long runs of them.
 */
 void removeElement(SET *sp, char *elt){
     bool exists;
-    int loc = search(sp, elt, &exists);
+    int loc = locate(sp, elt, &exists);
 
     if(exists){
-        for(int i = loc; i < sp->count-1; i++){
-            sp->data[i] = strdup(sp->data[i + 1]);
+        arenaFree(sp -> strings, sp -> data[at(sp, loc)]);
+        if(sp -> indexed != 0){
+            sp -> dead[loc] = true;
+            sp->count--;
+            if(sp -> count < sp -> indexed / 2){
+                dropIndex(sp);
+            }
+            return;
         }
-        sp -> data[sp -> count - 1] = NULL;
+        moveGap(sp, loc);
         sp->count--;
     }
 }
 /*
-* Big-O: O(1)
+* Big-O: O(log n)
 * 
 * This function takes in the parameter elt which is an element that the user wants to check exists in the set. 
 * The function uses the search function to find the location and check if the element does exist by storing a ture or fales value in the exists boolean variable.
@@ -140,20 +378,177 @@ void removeElement(SET *sp, char *elt){
 */
 char *findElement(SET *sp, char *elt){
     bool exists;
-    int loc = search(sp, elt, &exists);
-    return exists ? sp->data[loc] : NULL;
+    int loc = locate(sp, elt, &exists);
+    return exists ? sp->data[at(sp, loc)] : NULL;
 }
 /*
 * Big-O: O(n)
 *
-* This function collets every element from the array and duplicates it into a new array of strings that it returns at the end. Since it has a loop, it is Big-O of n.
+* This function collects every element from the array into a new array that it returns at the end, copying the elements before the gap and
+then the ones after it. Since it copies every element, it is Big-O of n.
+* The strings themselves are not copied. They still belong to the set, so the caller only frees the array, and the strings stay valid until they
+are removed or the set is destroyed.
+* If there is an index, the elements removed since it was built are skipped.
 */
 char **getElements(SET *sp){
-    char **elts = malloc(8 * sp -> count);
+    char **elts = malloc(sizeof(char *) * sp -> count);
+    assert(elts != NULL);
+    if(sp -> indexed != 0){
+        for(int i = 0, n = 0; i < sp -> indexed; i++){
+            if(!sp -> dead[i]){
+                elts[n++] = sp -> data[i];
+            }
+        }
+        return elts;
+    }
+    memcpy(elts, sp -> data, sizeof(char *) * sp -> gap);
+    memcpy(elts + sp -> gap, sp -> data + at(sp, sp -> gap), sizeof(char *) * (sp -> count - sp -> gap));
+    return elts;
+}
+/*
+* Big-O: O(1)
+*
+* This function compares the strings that a and b point to, so that qsort can sort a batch of elements the same way search expects.
+*/
+static int compare(const void *a, const void *b){
+    return strcmp(*(char **) a, *(char **) b);
+}
+/*
+* Big-O: O(m log n + m log m)
+*
+* This function copies the elements of the m in elts that are in the set if present is true, or not in it if present is false, into a new
+array. Since most of the words in a text are repeats, searching for each one first, which uses the index once there have been enough
+lookups, leaves far fewer elements to sort. It then sorts the new array and removes the duplicates, which are next to each other once
+it is sorted. It returns the new array and stores the # of distinct elements in m. The caller's array is left as it was.
+*/
+static char **sortBatch(SET *sp, char **elts, int *m, bool present){
+    char **batch = malloc(sizeof(char *) * *m);
+    int i, n = 0;
+    bool found;
+    assert(batch != NULL);
+    for(i = 0; i < *m; i++){
+        locate(sp, elts[i], &found);
+        if(found == present){
+            batch[n++] = elts[i];
+        }
+    }
+    qsort(batch, n, sizeof(char *), compare);
+    *m = n;
+    n = 0;
+    for(i = 0; i < *m; i++){
+        if(n == 0 || strcmp(batch[n - 1], batch[i]) != 0){
+            batch[n++] = batch[i];
+        }
+    }
+    *m = n;
+    return batch;
+}
+/*
+* Big-O: O(m log n + n)
+*
+* This function adds the m elements in elts to the set all at once. Adding them one at a time moves up to n elements for each, which is O(mn),
+while this sorts the new elements of the batch and then merges them with the array.
+* The index is thrown away and the gap moved to the end, so the elements are the first count slots of data. sortBatch only keeps the elements
+that are not in the set, so all m of them are new and the set grows by exactly m. The merge goes from the back, putting the larger of the last
+element and the last new element in the last free slot. Since the free slots always outnumber the elements still to be moved by the # of new
+elements left, nothing is overwritten before it is moved, and the elements that are already in the set stay put once the batch runs out.
+*/
+void addElements(SET *sp, char **elts, int m){
+    char **batch;
+    int i, j, w, cmp;
+    assert(sp != NULL && (elts != NULL || m == 0));
 
-    for(int i = 0; i < sp -> count; i++){
-        elts[i] = strdup(sp -> data[i]);
+    if(m <= 0){
+        return;
+    }
+    batch = sortBatch(sp, elts, &m, false);
+    if(m == 0){
+        free(batch);
+        return;
     }
+    if(sp -> indexed != 0){
+        dropIndex(sp);
+    }
+    moveGap(sp, sp -> count);
+    assert(sp -> count + m <= sp -> length);
 
-    return elts;
-}
\ No newline at end of file
+    for(i = sp -> count - 1, j = m - 1, w = sp -> count + m - 1; j >= 0;){
+        cmp = i >= 0 ? strcmp(sp -> data[i], batch[j]) : -1;
+        STAT(sp -> stats.compares++);
+        if(cmp > 0){
+            sp -> data[w--] = sp -> data[i--];
+        }
+        else{
+            sp -> data[w--] = arenaCopy(sp -> strings, batch[j--]);
+        }
+    }
+
+    sp -> count += m;
+    sp -> gap = sp -> count;
+    sp -> lookups = 0;
+    free(batch);
+}
+/*
+* Big-O: O(m log n + n)
+*
+* This function removes the m elements in elts from the set all at once by sorting the batch and then merging it with the array, which takes
+the difference of the two in a single pass. Only the elements of the batch that are in the set are sorted. Each element of the set is kept by moving it down to the next free slot unless the batch has it,
+in which case its string is handed back to the arena instead.
+*/
+void removeElements(SET *sp, char **elts, int m){
+    char **batch;
+    int i, j = 0, w = 0, cmp;
+    assert(sp != NULL && (elts != NULL || m == 0));
+
+    if(m <= 0){
+        return;
+    }
+    batch = sortBatch(sp, elts, &m, true);
+    if(m == 0){
+        free(batch);
+        return;
+    }
+    if(sp -> indexed != 0){
+        dropIndex(sp);
+    }
+    moveGap(sp, sp -> count);
+
+    for(i = 0; i < sp -> count; i++){
+        for(cmp = 1; j < m; j++){
+            cmp = strcmp(batch[j], sp -> data[i]);
+            STAT(sp -> stats.compares++);
+            if(cmp >= 0){
+                break;
+            }
+        }
+        if(cmp == 0){
+            arenaFree(sp -> strings, sp -> data[i]);
+            j++;
+        }
+        else{
+            sp -> data[w++] = sp -> data[i];
+        }
+    }
+
+    sp -> count = w;
+    sp -> gap = w;
+    free(batch);
+}
+#ifdef SETSTATS
+/*
+* Big-O: O(1)
+*
+* This function copies the counters kept for the set into out. Since this set does not hash, hashes is 0, and the array is never resized.
+The tombstones are the elements removed since the index was built, if there is one.
+* The bytes are the data array allocated in createSet plus the chunks of the arena that holds the strings and the index.
+*/
+void getSetStats(SET *sp, struct setstats *out){
+    assert(sp != NULL && out != NULL);
+    *out = sp -> stats;
+    out -> tombstones = sp -> indexed != 0 ? sp -> indexed - sp -> count : 0;
+    out -> bytes = sizeof(SET) + (long) sp -> length * sizeof(char *) + arenaBytes(sp -> strings);
+    if(sp -> indexed != 0){
+        out -> bytes += (long) (sp -> indexed + 1) * (sizeof(unsigned long long) + sizeof(int)) + sp -> indexed * sizeof(bool);
+    }
+}
+#endif
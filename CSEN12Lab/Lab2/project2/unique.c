@@ -19,6 +19,7 @@
 # include <string.h>
 # include <stdbool.h>
 # include "set.h"
+# include "tokens.h"
 
 
 /* This is sufficient for the test cases in /scratch/coen12. */
@@ -26,6 +27,12 @@
 # define MAX_SIZE 18800
 
 
+/* The number of words read before they are added to or removed from the
+   set all at once. */
+
+# define BATCH 65536
+
+
 /*
  * Function:    main
  *
@@ -34,11 +41,14 @@
 
 int main(int argc, char *argv[])
 {
-    FILE *fp;
-    char buffer[BUFSIZ], **elts;
+    TOKENS *tp;
+    char *buffer, **elts, **batch;
     SET *unique;
-    int i, words;
+    int i, n, words;
     bool lflag = false;
+# ifdef SETSTATS
+    struct setstats stats;
+# endif
 
 
     /* Check usage and open the first file. */
@@ -56,23 +66,35 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
 
-    if ((fp = fopen(argv[1], "r")) == NULL) {
+    if ((tp = openTokens(argv[1])) == NULL) {
         fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
         exit(EXIT_FAILURE);
     }
 
 
-    /* Insert all words into the set. */
+    /* Insert all words into the set, a batch at a time.  The words point
+       into the tokenizer, so they stay valid until it is closed. */
 
     words = 0;
     unique = createSet(MAX_SIZE);
 
-    while (fscanf(fp, "%s", buffer) == 1) {
-        words ++;
-        addElement(unique, buffer);
+    batch = malloc(sizeof(char *) * BATCH);
+    if (batch == NULL) {
+	fprintf(stderr, "%s: out of memory\n", argv[0]);
+	exit(EXIT_FAILURE);
     }
 
-    fclose(fp);
+    for (n = 0; (buffer = nextToken(tp, NULL)) != NULL; words ++) {
+	batch[n ++] = buffer;
+
+	if (n == BATCH) {
+	    addElements(unique, batch, n);
+	    n = 0;
+	}
+    }
+
+    addElements(unique, batch, n);
+    closeTokens(tp);
 
     if (!lflag) {
 	printf("%d total words\n", words);
@@ -83,7 +105,7 @@ int main(int argc, char *argv[])
     /* Try to open the second file. */
 
     if (argc == 3) {
-        if ((fp = fopen(argv[2], "r")) == NULL) {
+        if ((tp = openTokens(argv[2])) == NULL) {
             fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[2]);
             exit(EXIT_FAILURE);
         }
@@ -91,10 +113,17 @@ int main(int argc, char *argv[])
 
         /* Delete all words in the second file. */
 
-        while (fscanf(fp, "%s", buffer) == 1)
-            removeElement(unique, buffer);
+        for (n = 0; (buffer = nextToken(tp, NULL)) != NULL; ) {
+	    batch[n ++] = buffer;
+
+	    if (n == BATCH) {
+		removeElements(unique, batch, n);
+		n = 0;
+	    }
+	}
 
-	fclose(fp);
+	removeElements(unique, batch, n);
+	closeTokens(tp);
 
 	if (!lflag)
 	    printf("%d remaining words\n", numElements(unique));
@@ -112,6 +141,13 @@ int main(int argc, char *argv[])
 	free(elts);
     }
 
+    free(batch);
+
+# ifdef SETSTATS
+    getSetStats(unique, &stats);
+    printSetStats(&stats);
+# endif
+
     destroySet(unique);
     exit(EXIT_SUCCESS);
 }
@@ -4,17 +4,34 @@
 * Last Updated: 10/9/2024
 * Description: This file an implementation of the Set ADT using an unsorted array. This can be used with the parity.c and unique.c files to run
 a variety of comparissons. The search algorithm used in this implementation is a sequential/linear search.
+* Alongside each element the set keeps a 16-bit fingerprint, which is a hash of the string. A search goes through the fingerprints, 8 at a time
+with SSE2, and only calls strcmp on the elements whose fingerprint matches, which is usually just the one being looked for.
+* Compiling with MOVE_TO_FRONT or TRANSPOSE defined makes the array self-organizing, so that a word that was just found is moved forward.
 */
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include "set.h"
+#include "arena.h"
 #include <assert.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef SETSTATS
+#define STAT(x) (x)
+#else
+#define STAT(x)
+#endif
 
 struct set{
     int count;
     int length;
     char **data;
+    unsigned short *prints;
+    ARENA *strings;
+#ifdef SETSTATS
+    struct setstats stats;
+#endif
 };
 /*
 * Big-O: O(1)
@@ -29,20 +46,73 @@ SET *createSet(int maxElts){
     sp = malloc(sizeof(SET));
     assert(sp != NULL);
     sp -> data = malloc(sizeof(char *) * maxElts);
+    sp -> prints = malloc(sizeof(unsigned short) * maxElts);
+    assert(sp -> data != NULL && sp -> prints != NULL);
+    sp -> strings = createArena();
     sp -> length = maxElts;
     sp -> count = 0;
+    STAT(memset(&sp -> stats, 0, sizeof(sp -> stats)));
+    return sp;
+}
+#ifdef SETSTATS
+/*
+* Big-O: O(1)
+*
+* This function counts one search that made probes string compares, adding it to the histogram and the longest probe length.
+*/
+static void record(SET *sp, int probes){
+    sp -> stats.searches++;
+    sp -> stats.probes[probes < SETSTATS_BUCKETS ? probes : SETSTATS_BUCKETS - 1]++;
+    if(probes > sp -> stats.maxProbe){
+        sp -> stats.maxProbe = probes;
+    }
+}
+#endif
+/*
+* Big-O: O(m)
+*
+* This function returns the fingerprint of the string s. It is the same hash as strhash in the hash table with its upper half folded into its
+lower half, so that every character has a say in the 16 bits that are kept.
+*/
+static unsigned short fingerprint(char *s){
+    unsigned hash = 0;
+    while(*s != '\0'){
+        hash = 31 * hash + *s++;
+    }
+    return hash ^ hash >> 16;
 }
 /*
 * Big-O: O(n)
 *
-* This is the search function that finds the index of a given item elt and returns said index. If it fails to find it, it returns a -1. 
-* The searching algorithm implemented in the search function is sequential search. The reason why it is O(n) is because it has a loop.
-* This searching algorithm works by going through every element in the array until it finds the element elt. 
-*/
-static int search(SET *sp, char *elt){
-    for(int i = 0; i < sp -> count; i++){
-        if(strcmp(sp -> data[i], elt) == 0){
-            return i;
+* This is the scan function that finds the index of a given item elt with fingerprint fp and returns said index. If it fails to find it, it returns a -1. 
+* The searching algorithm implemented in the scan function is sequential search. The reason why it is O(n) is because it has a loop.
+* This searching algorithm works by going through every fingerprint in the array until it finds one equal to fp whose element is elt.
+* With SSE2, 8 fingerprints are compared with fp at once, giving a mask with 2 bits for each one that is equal. Only the low bit of each
+pair is kept, and the matches are found in order by counting the trailing zeros of the mask.
+*/
+static int scan(SET *sp, char *elt, unsigned short fp){
+    int i = 0;
+#ifdef __SSE2__
+    __m128i key = _mm_set1_epi16(fp);
+    for(; i + 8 <= sp -> count; i += 8){
+        __m128i prints = _mm_loadu_si128((__m128i *) (sp -> prints + i));
+        unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi16(prints, key)) & 0x5555;
+        while(mask != 0){
+            int j = i + __builtin_ctz(mask) / 2;
+            STAT(sp -> stats.compares++);
+            if(strcmp(sp -> data[j], elt) == 0){
+                return j;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for(; i < sp -> count; i++){
+        if(sp -> prints[i] == fp){
+            STAT(sp -> stats.compares++);
+            if(strcmp(sp -> data[i], elt) == 0){
+                return i;
+            }
         }
     }
     return -1;
@@ -50,14 +120,61 @@ static int search(SET *sp, char *elt){
 /*
 * Big-O: O(n)
 *
-* This function loops through the entire data array and deallocates any memory allocated to the elements of the data array and then nukes the data array pointer
-and the pointer to the entire set. The reason why it is O(n) is because it has a loop.
+* This function moves the element at index i, which a search just found, toward the front of the array along with its fingerprint, and returns
+its new index. Since word frequencies are very uneven, the common words end up at the front where the scan finds them first.
+* With MOVE_TO_FRONT defined, the element becomes the first one and the ones before it move back a slot, which is O(n). With TRANSPOSE defined,
+it only trades places with the one before it, which is O(1) but takes more searches to bring a word forward. Otherwise the order is left alone.
 */
-void destroySet(SET *sp){
-    for(int i = 0; i < sp -> count; i++){
-        free(sp -> data[i]);
+static int organize(SET *sp, int i){
+#if defined(MOVE_TO_FRONT)
+    char *elt = sp -> data[i];
+    unsigned short fp = sp -> prints[i];
+    memmove(sp -> data + 1, sp -> data, sizeof(char *) * i);
+    memmove(sp -> prints + 1, sp -> prints, sizeof(unsigned short) * i);
+    sp -> data[0] = elt;
+    sp -> prints[0] = fp;
+    return 0;
+#elif defined(TRANSPOSE)
+    if(i > 0){
+        char *elt = sp -> data[i];
+        unsigned short fp = sp -> prints[i];
+        sp -> data[i] = sp -> data[i - 1];
+        sp -> prints[i] = sp -> prints[i - 1];
+        sp -> data[i - 1] = elt;
+        sp -> prints[i - 1] = fp;
+        i--;
     }
+    return i;
+#else
+    return i;
+#endif
+}
+/*
+* Big-O: O(n)
+*
+* This is the search function that scans for elt with fingerprint fp, moves it forward if it was found, and returns its index or -1.
+* The instrumentation counts the calls to strcmp as compares, which scan does on the elements with a matching fingerprint, and every element
+the scan looked at as scanned, which is what moving elements forward cuts down.
+*/
+static int search(SET *sp, char *elt, unsigned short fp){
+    int i = scan(sp, elt, fp);
+#ifdef SETSTATS
+    sp -> stats.hashes++;
+    sp -> stats.scanned += i != -1 ? i + 1 : sp -> count;
+    record(sp, i != -1 ? i + 1 : sp -> count);
+#endif
+    return i != -1 ? organize(sp, i) : -1;
+}
+/*
+* Big-O: O(1)
+*
+* This function deallocates the arena that holds every string in the set all at once, and then nukes the data array pointer
+and the pointer to the entire set. Since the strings don't have to be freed one at a time there is no loop, so it is O(1) in the number of elements.
+*/
+void destroySet(SET *sp){
+    destroyArena(sp -> strings);
     free(sp -> data);
+    free(sp -> prints);
     free(sp);
 }
 /*
@@ -77,19 +194,24 @@ int numElements(SET *sp){
 8 Eeven this function contains the search method which is o(n), it is only counted as 1 operation as it is just called.
 */
 void addElement(SET *sp, char *elt){
+    unsigned short fp = fingerprint(elt);
     assert(sp -> count < sp -> length);
-    if(search(sp,elt) == -1){
-        sp -> data[sp -> count++] = strdup(elt);
+    if(search(sp, elt, fp) == -1){
+        sp -> prints[sp -> count] = fp;
+        sp -> data[sp -> count++] = arenaCopy(sp -> strings, elt);
     }
 }
 /*
 * Big-O: O(1)
 * 
-* This function removes an element from the array and replaces the last element in the array into the element that was removed's position. It then decrements count.
+* This function removes an element from the array and replaces the last element in the array into the element that was removed's position, along with its fingerprint. It then decrements count.
+* The removed string is handed back to the arena so that its space can be used by a later string of the same size.
 */
 void removeElement(SET *sp, char *elt){
-    int i = search(sp, elt);
+    int i = search(sp, elt, fingerprint(elt));
     if(i != -1){
+        arenaFree(sp -> strings, sp -> data[i]);
+        sp -> prints[i] = sp -> prints[sp -> count - 1];
         sp -> data[i] = sp -> data[sp -> count - 1];
         sp -> data[sp -> count - 1] = NULL;
         sp -> count--;
@@ -101,7 +223,7 @@ void removeElement(SET *sp, char *elt){
 * This function finds an element in the array and then returns the pointer to it. If it fails to find it, it then returns NULL.
 */
 char *findElement(SET *sp, char *elt){
-    int index = search(sp, elt);
+    int index = search(sp, elt, fingerprint(elt));
     if(index != -1){
         return sp -> data[index];
     }
@@ -110,13 +232,50 @@ char *findElement(SET *sp, char *elt){
 /*
 * Big-O: O(n)
 *
-* This function collets every element from the array and duplicates it into a new array of strings that it returns at the end. Since it has a loop, it is Big-O of n.
+* This function collects every element from the array into a new array that it returns at the end. Since it has a loop, it is Big-O of n.
+* The strings themselves are not copied. They still belong to the set, so the caller only frees the array, and the strings stay valid until they
+are removed or the set is destroyed.
 */
 char **getElements(SET *sp){
-    char **elts = malloc(8 * sp -> count);
-    for(int i = 0; i < sp -> count; i++){
-        elts[i] = strdup(sp -> data[i]);
-    }
-
+    char **elts = malloc(sizeof(char *) * sp -> count);
+    assert(elts != NULL);
+    memcpy(elts, sp -> data, sizeof(char *) * sp -> count);
     return elts;
-}
\ No newline at end of file
+}
+/*
+* Big-O: O(mn)
+*
+* This function adds the m elements in elts to the set one at a time. Since the array is not sorted, there is nothing to merge the elements with,
+so each one still has to be searched for with sequential search.
+*/
+void addElements(SET *sp, char **elts, int m){
+    for(int i = 0; i < m; i++){
+        addElement(sp, elts[i]);
+    }
+}
+/*
+* Big-O: O(mn)
+*
+* This function removes the m elements in elts from the set one at a time, searching for each one with sequential search.
+*/
+void removeElements(SET *sp, char **elts, int m){
+    for(int i = 0; i < m; i++){
+        removeElement(sp, elts[i]);
+    }
+}
+#ifdef SETSTATS
+/*
+* Big-O: O(1)
+*
+* This function copies the counters kept for the set into out. Since removing moves the last element into the hole, tombstones is 0, and the array is never resized.
+* The hashes are the fingerprints computed, the compares are the calls to strcmp made when a fingerprint matched, and scanned is the
+slots each search looked at.
+* The bytes are the data and fingerprint arrays allocated in createSet plus the chunks of the arena that holds the strings.
+*/
+void getSetStats(SET *sp, struct setstats *out){
+    assert(sp != NULL && out != NULL);
+    *out = sp -> stats;
+    out -> tombstones = 0;
+    out -> bytes = sizeof(SET) + (long) sp -> length * (sizeof(char *) + sizeof(unsigned short)) + arenaBytes(sp -> strings);
+}
+#endif
@@ -15,6 +15,7 @@
 # include <string.h>
 # include <assert.h>
 # include "set.h"
+# include "tokens.h"
 
 struct entry {
     char *word;
@@ -77,8 +78,8 @@ static int compareEntries(struct entry *ep1, struct entry *ep2)
 
 int main(int argc, char *argv[])
 {
-    FILE *fp;
-    char buffer[BUFSIZ];
+    TOKENS *tp;
+    char *buffer;
     struct entry e, *ep, **entries;
     SET *counts;
     int i;
@@ -91,7 +92,7 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
 
-    if ((fp = fopen(argv[1], "r")) == NULL) {
+    if ((tp = openTokens(argv[1])) == NULL) {
         fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
         exit(EXIT_FAILURE);
     }
@@ -101,7 +102,7 @@ int main(int argc, char *argv[])
 
     counts = createSet(MAX_SIZE, compareEntries, hashEntry);
 
-    while (fscanf(fp, "%s", buffer) == 1) {
+    while ((buffer = nextToken(tp, NULL)) != NULL) {
 	e.word = buffer;
 	ep = findElement(counts, &e);
 
@@ -119,6 +120,8 @@ int main(int argc, char *argv[])
 	    ep->count ++;
     }
 
+    closeTokens(tp);
+
 
     /* Print out the counts for each word. */
 
@@ -5,6 +5,10 @@
 * Last Updated: 10/24/2024
 * Description: This is the generics implementation for a hash table implementation of a Set ADT. This can be compiled with the parity.c, unique.c, and counts.c
 files to allow for each other file to work as intended.
+* Collisions are resolved with Robin Hood linear probing, and deletions shift the following elements back instead of leaving a
+"deleted" flag behind, so the table never fills up with deleted slots.
+* The table grows to about twice its length when it gets three quarters full or when an insertion needs a probe sequence longer than
+MAX_PROBE, so probe sequences stay short no matter how many elements are added.
 */
 #include <stdlib.h>
 #include <stdio.h>
@@ -12,88 +16,197 @@ files to allow for each other file to work as intended.
 #include "set.h"
 #include <assert.h>
 #include <stdbool.h>
+#define MAX_LOAD(n) ((n) / 4 * 3) //the most filled slots in a table of n slots before it grows
+#define MAX_PROBE 32 //the longest probe sequence allowed before the table grows
+#ifdef SETSTATS
+#define STAT(x) (x)
+#else
+#define STAT(x)
+#endif
 /*
 * This is the set struct that defines all the elements that make up a set for a generics implementation.
 * The data includes a hash function pointer and a compare function pointer.
+* dists holds the probe distance of each filled slot, which is how far it sits from the slot its hash maps to.
+* maxProbe is the longest probe sequence that any element in the current table has needed.
 */
 struct set{
     int count;
     int length;
+    int maxProbe;
     char **data;
+    unsigned *hashes;
+    int *dists;
     char *flags;
     int (*compare)();
     unsigned (*hash)();
+#ifdef SETSTATS
+    struct setstats stats;
+#endif
 };
 /*
 * Big-O: O(n)
 *
-* Since this function uses a loop to pre-fill each flag with the value "E" (aka empty), the big o of the function is O(n)
+* This function allocates the arrays of the set for a table of length slots and flags every slot "E" (aka empty).
+*/
+static void allocate(SET *sp, int length){
+    sp -> data = malloc(sizeof(void *) * length);
+    sp -> hashes = malloc(sizeof(unsigned) * length);
+    sp -> dists = malloc(sizeof(int) * length);
+    sp -> flags = malloc(length);
+    assert(sp -> data != NULL && sp -> hashes != NULL && sp -> dists != NULL && sp -> flags != NULL);
+    for(int i = 0; i < length; i++){
+        sp -> flags[i] = 'E';
+    }
+    sp -> length = length;
+    sp -> maxProbe = 0;
+}
+/*
+* Big-O: O(n)
+*
+* Since allocate uses a loop to pre-fill each flag with the value "E" (aka empty), the big o of the function is O(n)
 * The goal of this function is allocate all the memory required for the set and also sets values for the count and length variables.
+* maxElts is only the starting length of the table, since it grows as elements are added.
 * In addition to the variables, the function poitners for the compare function and hash function are set to the parameters hash and compare.
 * However, first it checks if the compare and hash function pointers are NULL to ensure that they aren't set to NULL which would cause issues in other functions.
+* The hashes array keeps the full hash of the element in each slot so that the hash function never has to be called on it again.
 */
 SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)()){
     SET *sp;
 
     sp = malloc(sizeof(SET));
     assert(sp != NULL);
-    sp -> data = malloc(sizeof(void *) * maxElts);
-    sp -> flags = malloc(maxElts);
-    for(int i = 0; i < maxElts; i++){
-        sp -> flags[i] = 'E';
-    }
-    sp -> length = maxElts;
+    allocate(sp, maxElts);
     sp -> count = 0; 
+    STAT(memset(&sp -> stats, 0, sizeof(sp -> stats)));
     assert(*compare != NULL && *hash != NULL);
     sp -> hash = hash;
     sp -> compare = compare;   
+    return sp;
+}
+/*
+* Big-O: O(1)
+*
+* This function scrambles the hash h so that every bit of it depends on every bit of the hash it was given. Hashes of similar elements
+are often close together, which would put the elements in one long run of slots, so every hash is mixed before it is used.
+*/
+static unsigned mix(unsigned h){
+    h ^= h >> 16;
+    h *= 0x45d9f3b;
+    h ^= h >> 16;
+    return h;
+}
+#ifdef SETSTATS
+/*
+* Big-O: O(1)
+*
+* This function counts one search that looked at probes slots, adding it to the histogram and the longest probe length.
+*/
+static void record(SET *sp, int probes){
+    sp -> stats.searches++;
+    sp -> stats.probes[probes < SETSTATS_BUCKETS ? probes : SETSTATS_BUCKETS - 1]++;
+    if(probes > sp -> stats.maxProbe){
+        sp -> stats.maxProbe = probes;
+    }
 }
+#endif
 /*
 * Big-O: O(n)
 *
 * This is the search function that finds the index of a given item elt and returns said index if found. When the location is not found
 * initially, it will then probe to the next location that the given element can be. 
-* The location i is calculated by hashing the element then adding the probe value and then applying the modulo operation
-* on the hashed value.
-* If the location that is found has a flag of 'D' and the first available slot variable is equal to its default value of -1, 
-* availabe is then set to the current i value, which is then recaclculated with the new probe value. 
+* The caller hashes elt once and passes the value in as hash. The starting location is the hash modulo the length and each probe
+* moves one slot to the right, wrapping around at the end of the array.
+* A filled slot is only passed to the compare function if the hash stored for it matches, so most occupied slots are skipped with one integer compare.
+* Because insertion is done Robin Hood style, the search can stop as soon as it reaches an empty slot or a slot whose element is closer
+to its own home than elt would be at that point, since elt would have taken that slot.
+* If elt is not found, the returned location is where it belongs and *dist is the probe distance it would have there.
 */
-static int search(SET *sp, void *elt, bool *found){
+static int search(SET *sp, void *elt, unsigned hash, int *dist, bool *found){
     assert(sp != NULL && elt != NULL);
-    int available, i, probe;
-    probe = 0;
-    available = -1;
-    i = ((*sp -> hash)(elt)) % sp -> length;
-    while(i < sp -> length){
-        assert(i < sp -> length);
-        if(sp -> flags[i] == 'F'){
+    int i = hash % sp -> length;
+    *found = false;
+    STAT(sp -> stats.hashes++);
+    for(*dist = 0; *dist < sp -> length; (*dist)++){
+        if(sp -> flags[i] == 'E' || sp -> dists[i] < *dist){
+            STAT(record(sp, *dist + 1));
+            return i;
+        }
+        if(sp -> hashes[i] == hash){
+            STAT(sp -> stats.compares++);
             if((*sp -> compare)(elt, sp -> data[i]) == 0){
+                STAT(record(sp, *dist + 1));
                 *found = true;
-                available = i; 
-                i = sp ->length;
+                return i;
             }
-            probe++;
-            i = ((*sp -> hash)(elt) + probe) % sp -> length;
         }
-        else if(sp -> flags[i] == 'D' && available == -1){
-            available = i;
-            probe++;
-            i = ((*sp -> hash)(elt) + probe) % sp -> length;
+        if(++i == sp -> length){
+            i = 0;
         }
-        else if(sp -> flags[i] == 'D'){
-            probe++;
-            i = ((*sp -> hash)(elt) + probe) % sp -> length;
+    }
+    STAT(record(sp, sp -> length));
+    return -1;
+}   
+/*
+* Big-O: O(n)
+*
+* This function places elt, along with its hash, at location i where its probe distance is dist.
+* If that slot is filled by an element that is closer to its home than elt is, the two are swapped and the element that was there
+continues to the right looking for its own place. Taking slots from the elements that are "rich" in probe distance keeps the longest
+probe sequence short. The first empty slot ends the loop.
+*/
+static void insert(SET *sp, int i, void *elt, unsigned hash, int dist){
+    while(sp -> flags[i] == 'F'){
+        if(sp -> dists[i] < dist){
+            void *tempElt = sp -> data[i];
+            unsigned tempHash = sp -> hashes[i];
+            int tempDist = sp -> dists[i];
+            sp -> data[i] = elt;
+            sp -> hashes[i] = hash;
+            sp -> dists[i] = dist;
+            if(dist + 1 > sp -> maxProbe){
+                sp -> maxProbe = dist + 1;
+            }
+            elt = tempElt;
+            hash = tempHash;
+            dist = tempDist;
         }
-        else if(available == -1){
-            available = i;
-            i = sp->length;
+        if(++i == sp -> length){
+            i = 0;
         }
-        else{
-            i = sp->length;
+        dist++;
+    }
+    sp -> data[i] = elt;
+    sp -> hashes[i] = hash;
+    sp -> dists[i] = dist;
+    sp -> flags[i] = 'F';
+    if(dist + 1 > sp -> maxProbe){
+        sp -> maxProbe = dist + 1;
+    }
+}
+/*
+* Big-O: O(n)
+*
+* This function replaces the table with one twice as long and inserts every element again.
+* The stored hashes give each element its new home slot, so no element is hashed or compared again, and insert sorts out the probe
+distances Robin Hood style as before.
+*/
+static void grow(SET *sp){
+    int length = sp -> length;
+    char **data = sp -> data;
+    unsigned *hashes = sp -> hashes;
+    char *flags = sp -> flags;
+    free(sp -> dists);
+    allocate(sp, length * 2);
+    STAT(sp -> stats.resizes++);
+    for(int i = 0; i < length; i++){
+        if(flags[i] == 'F'){
+            insert(sp, hashes[i] % sp -> length, data[i], hashes[i], 0);
         }
     }
-    return available;
-}   
+    free(data);
+    free(hashes);
+    free(flags);
+}
 /*
 * Big-O: O(1)
 *
@@ -103,6 +216,8 @@ static int search(SET *sp, void *elt, bool *found){
 void destroySet(SET *sp){
     assert(sp != NULL);
     free(sp -> data);
+    free(sp -> hashes);
+    free(sp -> dists);
     free(sp -> flags);
     free(sp);
 }
@@ -119,17 +234,25 @@ int numElements(SET *sp){
 * Big-O: O(n)
 *
 * The Big-O is O(n) as the search function is a O(n) operation and I made the method, therefore I must account for its Big-O runtime
-* Add element makes sure the element exists and then if it does not, it will then add the elt by setting the location to the elt value instead of copying the memory as we do not have a predefined type.
-* It will then define the flag at the location as "F", representing filled.
+* Add element makes sure the element exists and then if it does not, it will then insert elt itself at the location that search returned,
+which may push other elements further down the table. We do not copy the memory as we do not have a predefined type.
+* The hash of elt is computed once and stored next to the element.
+* If the table is three quarters full, or some element needed more than MAX_PROBE probes and the table is at least a quarter full, it
+grows first and elt is searched for again in the new table. The quarter full rule keeps a poor hash function from growing it forever.
 * Count is then incremented by 1.
 */
 void addElement(SET *sp, void *elt){
     bool exists = false;
+    int dist;
     assert(sp != NULL && elt != NULL);
-    int location = search(sp, elt, &exists);
+    unsigned hash = mix((*sp -> hash)(elt));
+    int location = search(sp, elt, hash, &dist, &exists);
     if(!exists){
-        sp -> data[location] = elt;
-        sp -> flags[location] = 'F';
+        if(sp -> count >= MAX_LOAD(sp -> length) || (sp -> maxProbe > MAX_PROBE && sp -> count >= sp -> length / 4)){
+            grow(sp);
+            location = search(sp, elt, hash, &dist, &exists);
+        }
+        insert(sp, location, elt, hash, dist);
         sp -> count++;
     }
 }
@@ -138,14 +261,25 @@ void addElement(SET *sp, void *elt){
 *
 * Since we have to use the search function to get the index of the element that we want to delete, the function is O(n).
 * Because we do not know the type of data being use and we also did not manually allocate the memory to each element in add element,
-we can just set the flag of the location to "D" which means the location is flagged for deletion which means it can be overrided.
+we do not free anything.
+* Every following element that is not in its home slot is shifted back one slot, which fills the hole and brings each of them
+one step closer to home. The last slot that was shifted from is then flagged as "E", so no deleted slots are ever left behind.
 */
 void removeElement(SET *sp, void *elt){
     assert(sp != NULL && elt != NULL);
     bool exists = false;
-    int location = search(sp, elt, &exists);
+    int dist;
+    int location = search(sp, elt, mix((*sp -> hash)(elt)), &dist, &exists);
     if(exists){
-        sp -> flags[location] = 'D';
+        int next = location + 1 == sp -> length ? 0 : location + 1;
+        while(sp -> flags[next] == 'F' && sp -> dists[next] > 0){
+            sp -> data[location] = sp -> data[next];
+            sp -> hashes[location] = sp -> hashes[next];
+            sp -> dists[location] = sp -> dists[next] - 1;
+            location = next;
+            next = location + 1 == sp -> length ? 0 : location + 1;
+        }
+        sp -> flags[location] = 'E';
         sp -> count--;
     }
 }
@@ -159,7 +293,8 @@ void removeElement(SET *sp, void *elt){
 void *findElement(SET *sp, void *elt){
     assert(sp != NULL && elt != NULL);
     bool exists = false;
-    int location = search(sp, elt, &exists);
+    int dist;
+    int location = search(sp, elt, mix((*sp -> hash)(elt)), &dist, &exists);
 
     return exists ? sp -> data[location] : NULL;
 }
@@ -186,3 +321,28 @@ void *getElements(SET *sp){
 
     return elts;
 }
+/*
+* Big-O: O(1)
+*
+* This function returns the longest probe sequence that any element in the current table has needed, counting the home slot.
+* Robin Hood insertion keeps this close to the average, so a large value points at a poor hash function rather than at clustering.
+*/
+int maxProbeLength(SET *sp){
+    assert(sp != NULL);
+    return sp -> maxProbe;
+}
+#ifdef SETSTATS
+/*
+* Big-O: O(1)
+*
+* This function copies the counters kept for the set into out. Deletions shift elements back instead of leaving deleted slots, and
+tombstones is always 0. resizes counts the calls to grow. The hash is computed once per search, so hashes is counted in search.
+* The bytes are the arrays allocated in createSet.
+*/
+void getSetStats(SET *sp, struct setstats *out){
+    assert(sp != NULL && out != NULL);
+    *out = sp -> stats;
+    out -> tombstones = 0;
+    out -> bytes = sizeof(SET) + (long) sp -> length * (sizeof(void *) + sizeof(unsigned) + sizeof(int) + 1);
+}
+#endif
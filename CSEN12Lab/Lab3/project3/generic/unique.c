@@ -19,6 +19,7 @@
 # include <string.h>
 # include <stdbool.h>
 # include "set.h"
+# include "tokens.h"
 
 
 /* This is sufficient for the test cases in /scratch/coen12. */
@@ -52,11 +53,14 @@ static unsigned strhash(char *s)
 
 int main(int argc, char *argv[])
 {
-    FILE *fp;
-    char buffer[BUFSIZ], **elts, *word;
+    TOKENS *tp;
+    char *buffer, **elts, *word;
     SET *unique;
     int i, words;
     bool lflag = false;
+# ifdef SETSTATS
+    struct setstats stats;
+# endif
 
 
     /* Check usage and open the first file. */
@@ -74,7 +78,7 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
 
-    if ((fp = fopen(argv[1], "r")) == NULL) {
+    if ((tp = openTokens(argv[1])) == NULL) {
         fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
         exit(EXIT_FAILURE);
     }
@@ -85,13 +89,13 @@ int main(int argc, char *argv[])
     words = 0;
     unique = createSet(MAX_SIZE, strcmp, strhash);
 
-    while (fscanf(fp, "%s", buffer) == 1) {
+    while ((buffer = nextToken(tp, NULL)) != NULL) {
         words ++;
 	if (!findElement(unique, buffer))
 	    addElement(unique, strdup(buffer));
     }
 
-    fclose(fp);
+    closeTokens(tp);
 
     if (!lflag) {
 	printf("%d total words\n", words);
@@ -102,7 +106,7 @@ int main(int argc, char *argv[])
     /* Try to open the second file. */
 
     if (argc == 3) {
-        if ((fp = fopen(argv[2], "r")) == NULL) {
+        if ((tp = openTokens(argv[2])) == NULL) {
             fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[2]);
             exit(EXIT_FAILURE);
         }
@@ -110,14 +114,14 @@ int main(int argc, char *argv[])
 
         /* Delete all words in the second file. */
 
-        while (fscanf(fp, "%s", buffer) == 1) {
+        while ((buffer = nextToken(tp, NULL)) != NULL) {
 	    if ((word = findElement(unique, buffer)) != NULL) {
 		removeElement(unique, buffer);
 		free(word);
 	    }
 	}
 
-	fclose(fp);
+	closeTokens(tp);
 
 	if (!lflag)
 	    printf("%d remaining words\n", numElements(unique));
@@ -135,6 +139,11 @@ int main(int argc, char *argv[])
 	free(elts);
     }
 
+# ifdef SETSTATS
+    getSetStats(unique, &stats);
+    printSetStats(&stats);
+# endif
+
     destroySet(unique);
     exit(EXIT_SUCCESS);
 }
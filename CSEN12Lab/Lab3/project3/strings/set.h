@@ -27,4 +27,21 @@ char *findElement(SET *sp, char *elt);
 
 char **getElements(SET *sp);
 
+int maxProbeLength(SET *sp);
+
+void addElements(SET *sp, char **elts, int n);
+
+void removeElements(SET *sp, char **elts, int n);
+
+
+/* Instrumentation, only compiled in when SETSTATS is defined. */
+
+# ifdef SETSTATS
+
+# include "setstats.h"
+
+void getSetStats(SET *sp, struct setstats *out);
+
+# endif /* SETSTATS */
+
 # endif /* SET_H */
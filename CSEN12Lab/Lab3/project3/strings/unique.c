@@ -19,6 +19,7 @@
 # include <string.h>
 # include <stdbool.h>
 # include "set.h"
+# include "tokens.h"
 
 
 /* This is sufficient for the test cases in /scratch/coen12. */
@@ -34,11 +35,14 @@
 
 int main(int argc, char *argv[])
 {
-    FILE *fp;
-    char buffer[BUFSIZ], **elts;
+    TOKENS *tp;
+    char *buffer, **elts;
     SET *unique;
     int i, words;
     bool lflag = false;
+# ifdef SETSTATS
+    struct setstats stats;
+# endif
 
 
     /* Check usage and open the first file. */
@@ -56,7 +60,7 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
 
-    if ((fp = fopen(argv[1], "r")) == NULL) {
+    if ((tp = openTokens(argv[1])) == NULL) {
         fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
         exit(EXIT_FAILURE);
     }
@@ -67,12 +71,12 @@ int main(int argc, char *argv[])
     words = 0;
     unique = createSet(MAX_SIZE);
 
-    while (fscanf(fp, "%s", buffer) == 1) {
+    while ((buffer = nextToken(tp, NULL)) != NULL) {
         words ++;
         addElement(unique, buffer);
     }
 
-    fclose(fp);
+    closeTokens(tp);
 
     if (!lflag) {
 	printf("%d total words\n", words);
@@ -83,7 +87,7 @@ int main(int argc, char *argv[])
     /* Try to open the second file. */
 
     if (argc == 3) {
-        if ((fp = fopen(argv[2], "r")) == NULL) {
+        if ((tp = openTokens(argv[2])) == NULL) {
             fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[2]);
             exit(EXIT_FAILURE);
         }
@@ -91,10 +95,10 @@ int main(int argc, char *argv[])
 
         /* Delete all words in the second file. */
 
-        while (fscanf(fp, "%s", buffer) == 1)
+        while ((buffer = nextToken(tp, NULL)) != NULL)
             removeElement(unique, buffer);
 
-	fclose(fp);
+	closeTokens(tp);
 
 	if (!lflag)
 	    printf("%d remaining words\n", numElements(unique));
@@ -112,6 +116,11 @@ int main(int argc, char *argv[])
 	free(elts);
     }
 
+# ifdef SETSTATS
+    getSetStats(unique, &stats);
+    printSetStats(&stats);
+# endif
+
     destroySet(unique);
     exit(EXIT_SUCCESS);
 }
@@ -5,11 +5,20 @@
 * Last Updated: 11/7/2024
 * Description: The implementation of the doubly linked circular linked list with a dummy node. Contains all the required
 interfacing functions for radix.c, maze.c, and table.c
+* Each list hands out its nodes from a slab of its own instead of calling malloc and free for every item. The slab is a chain of blocks
+aligned to a cache line, each one twice as big as the last up to MAX_NODES nodes. The first block holds just MIN_NODES nodes, so a short
+list like a bucket of a hash table takes a single cache line and an empty one takes none. A removed node goes on the list's free list, linked
+through its next pointer, and the next node added reuses it. All of the blocks are freed at once by destroyList.
+* concatList and spliceList move the whole chain of one list onto another, and the blocks of the slab of that list go along with its nodes,
+so every node in a list always comes from a block that the list itself owns and frees.
 */
 #include <stdlib.h>
 #include <stdio.h>
 #include "list.h"
 #include <assert.h>
+#define LINE 64 //the # of bytes in a cache line
+#define MIN_NODES 2 //the # of nodes in the first block of a slab, which fills one cache line
+#define MAX_NODES 256 //the most nodes in any block of a slab
 /*
 * This is the struct for a node in the linked list that the list struct would use.
 * It contains the data that is stored in the node and a prev and next pointer as this is a doubly linked list.
@@ -20,15 +29,31 @@ struct node{
     struct node *prev;
 }; 
 /*
+* This is the header at the start of each block of a slab. The nodes of the block come right after it.
+*/
+struct block{
+    struct block *next;
+};
+/*
 * This is the list struct that defines all the data required for a list to be a list.
 *
 * It has a head pointer that will always point to the dummy node and also has a compare as this is a generic linked list 
 that works with any data type that is comparable.
+* The rest is the slab. free is the list of removed nodes, next and end are the part of the newest block that has not been handed out yet,
+blocks is the chain of every block from the newest to the oldest, last is the oldest block, size is the # of nodes to put in the next block,
+and bytes is the # of bytes in all of the blocks.
 */
 struct list{
     int count;
     struct node *head;
     int (*compare)();
+    struct node *free;
+    struct node *next;
+    struct node *end;
+    struct block *blocks;
+    struct block *last;
+    int size;
+    long bytes;
 };
 /*
 * Big-O: O(1)
@@ -48,19 +73,99 @@ LIST *createList(int (*compare)()){
     lp -> head -> next = lp -> head;
     lp -> head -> prev = lp -> head;
     lp -> compare = compare;
+    lp -> free = NULL;
+    lp -> next = NULL;
+    lp -> end = NULL;
+    lp -> blocks = NULL;
+    lp -> last = NULL;
+    lp -> size = MIN_NODES;
+    lp -> bytes = 0;
     return lp;
 }
 /*
+* Big-O: O(1)
+*
+* This function returns a node from the slab of the list. It takes the first node off the free list if there is one, and otherwise the next
+node of the newest block. When the newest block is used up, a new one is allocated that is aligned to a cache line and rounded up to a whole
+number of lines, which may leave room for a few more nodes than size.
+*/
+static struct node *allocNode(LIST *lp){
+    struct node *np = lp -> free;
+    if(np != NULL){
+        lp -> free = np -> next;
+        return np;
+    }
+    if(lp -> next == lp -> end){
+        size_t bytes = (sizeof(struct block) + sizeof(struct node) * lp -> size + LINE - 1) / LINE * LINE;
+        struct block *bp = aligned_alloc(LINE, bytes);
+        assert(bp != NULL);
+        bp -> next = lp -> blocks;
+        lp -> blocks = bp;
+        if(lp -> last == NULL){
+            lp -> last = bp;
+        }
+        lp -> bytes += bytes;
+        lp -> next = (struct node *) (bp + 1);
+        lp -> end = lp -> next + (bytes - sizeof(struct block)) / sizeof(struct node);
+        if(lp -> size < MAX_NODES){
+            lp -> size *= 2;
+        }
+    }
+    return lp -> next++;
+}
+/*
+* Big-O: O(1)
+*
+* This function gives the node np back to the slab of the list by pushing it onto the free list.
+*/
+static void freeNode(LIST *lp, struct node *np){
+    np -> next = lp -> free;
+    lp -> free = np;
+}
+/*
+* Big-O: O(1)
+*
+* This function gives every block of the slab of src to dst, for when the nodes of src are moved onto dst. The chain of src goes in front of
+the chain of dst, which keeps the newest block first. The free nodes and the rest of the newest block of src are kept by dst if it has none
+of its own, and otherwise they stay unused until dst is destroyed. src is left with an empty slab of its own.
+*/
+static void moveSlab(LIST *dst, LIST *src){
+    if(src -> blocks == NULL){
+        return;
+    }
+    src -> last -> next = dst -> blocks;
+    dst -> blocks = src -> blocks;
+    if(dst -> last == NULL){
+        dst -> last = src -> last;
+    }
+    dst -> bytes += src -> bytes;
+    if(dst -> free == NULL){
+        dst -> free = src -> free;
+    }
+    if(dst -> next == dst -> end){
+        dst -> next = src -> next;
+        dst -> end = src -> end;
+    }
+    src -> free = NULL;
+    src -> next = NULL;
+    src -> end = NULL;
+    src -> blocks = NULL;
+    src -> last = NULL;
+    src -> size = MIN_NODES;
+    src -> bytes = 0;
+}
+/*
 * Big-O: O(n)
 *
-* This function goes through the entire list and frees each node and then ultimately frees the list pointer.
+* This function goes through the blocks of the slab and frees each one, which frees every node at once, and then ultimately frees the list pointer.
+* Since a block holds up to MAX_NODES nodes, there are far fewer blocks than nodes.
 */
 void destroyList(LIST *lp){
     assert(lp != NULL);
-    struct node *tbd = lp -> head -> next;
-    while(tbd != lp -> head){
-        struct node *del = tbd;
-        tbd = del -> next;
+    struct block *bp = lp -> blocks;
+    while(bp != NULL){
+        struct block *del = bp;
+        bp = del -> next;
         free(del);
     }
     free(lp -> head);
@@ -79,13 +184,13 @@ int numItems(LIST *lp){
 * Big-O: O(1)
 *
 * This function adds an element to the front of the linked list.
-* It allocates memory for the node and then sets all its variables.
+* It takes a node from the slab and then sets all its variables.
 * prev will always point to the dummy node and next will point to the element to the right of the dummy node (aka the first real node).
 */
 void addFirst(LIST *lp, void *item){
     assert(lp != NULL);
-    struct node *np = malloc(sizeof(struct node));
-    assert(np != NULL && item != NULL);
+    struct node *np = allocNode(lp);
+    assert(item != NULL);
     np -> data = item;
     np -> next = lp -> head -> next;
     np -> prev = lp -> head;
@@ -103,8 +208,8 @@ in the list that are modified.
 */
 void addLast(LIST *lp, void *item){
     assert(lp != NULL);
-    struct node *np = malloc(sizeof(struct node));
-    assert(np != NULL && item != NULL);
+    struct node *np = allocNode(lp);
+    assert(item != NULL);
     np -> data = item;
     np -> next = lp -> head;
     np -> prev = lp -> head -> prev;
@@ -116,7 +221,7 @@ void addLast(LIST *lp, void *item){
 * Big-O: O(1)
 *
 * This function removes the first element in the list and reconnects the other elements to one another.
-* The deleted node is then freed as we allocated memory to it when we added node in any of the addNode functions.
+* The deleted node is then given back to the slab that we took it from when we added node in any of the addNode functions.
 */
 void *removeFirst(LIST *lp){
     assert(lp != NULL);
@@ -127,14 +232,14 @@ void *removeFirst(LIST *lp){
     lp -> head -> next = del -> next;
     lp -> count--;
     void *data = del -> data;
-    free(del);
+    freeNode(lp, del);
     return data;
 }
 /*
 * Big-O: O(1)
 *
 * This function removes the last element in the list and reconnects the other elments to one another when the node is removed.
-* The deleted node is then freed as we allocated memory to it when we added node in any of the addNode functions.
+* The deleted node is then given back to the slab that we took it from when we added node in any of the addNode functions.
 */
 void *removeLast(LIST *lp){
     assert(lp != NULL);
@@ -145,7 +250,7 @@ void *removeLast(LIST *lp){
     lp -> head -> prev = del -> prev;
     lp -> count--;
     void *data = del -> data;
-    free(del);
+    freeNode(lp, del);
     return data;
 }
 /*
@@ -171,7 +276,7 @@ void *getLast(LIST *lp){
 *
 * Since we are only given the item (which is the data in a node), we need to search for it.
 * If the node is not found (aka when the del node pointer points to the head), you will not do any deletion.
-* If the node is found, it then goes through with the deletion process and frees the node to be deleted. 
+* If the node is found, it then goes through with the deletion process and gives the node to be deleted back to the slab. 
 */
 void removeItem(LIST *lp, void *item){
     assert(lp != NULL);
@@ -185,7 +290,7 @@ void removeItem(LIST *lp, void *item){
     if(del != lp -> head){
         del -> prev -> next = del -> next;
         del -> next -> prev = del -> prev;
-        free(del);
+        freeNode(lp, del);
     }
     lp -> count--;
 }
@@ -194,12 +299,30 @@ void removeItem(LIST *lp, void *item){
 *
 * Since we do not know which node the item is, we need to search for it. if it is found, the data in that node is immediately returned.
 * If the item is not found, NULL is returned.
+* With MOVE_TO_FRONT defined, the node that was found is unlinked and put back right after the dummy node. With TRANSPOSE defined, its data
+trades places with the data of the node before it instead. Either way the items that are looked for the most drift to the front of the list,
+so a later search for them stops sooner.
 */
 void *findItem(LIST *lp, void *item){
     assert(lp != NULL);
     struct node *np = lp -> head -> next;
     while(np != lp -> head){
         if(lp -> compare(np -> data, item) == 0){
+#if defined(MOVE_TO_FRONT)
+            np -> prev -> next = np -> next;
+            np -> next -> prev = np -> prev;
+            np -> next = lp -> head -> next;
+            np -> prev = lp -> head;
+            lp -> head -> next -> prev = np;
+            lp -> head -> next = np;
+#elif defined(TRANSPOSE)
+            if(np -> prev != lp -> head){
+                void *data = np -> data;
+                np -> data = np -> prev -> data;
+                np -> prev -> data = data;
+                np = np -> prev;
+            }
+#endif
             return np -> data;
         }
         np = np -> next;
@@ -207,6 +330,49 @@ void *findItem(LIST *lp, void *item){
     return NULL;
 }
 /*
+* Big-O: O(1)
+*
+* This function moves every item of src onto the end of dst, leaving src empty. Since the nodes are already linked to each other, only the
+pointers at the two ends of the chain of src and the end of dst have to change, no matter how many items there are.
+* The blocks that hold the nodes are moved to the slab of dst along with them.
+*/
+void concatList(LIST *dst, LIST *src){
+    assert(dst != NULL && src != NULL && dst != src);
+    if(src -> count == 0){
+        return;
+    }
+    src -> head -> next -> prev = dst -> head -> prev;
+    src -> head -> prev -> next = dst -> head;
+    dst -> head -> prev -> next = src -> head -> next;
+    dst -> head -> prev = src -> head -> prev;
+    src -> head -> next = src -> head;
+    src -> head -> prev = src -> head;
+    dst -> count += src -> count;
+    src -> count = 0;
+    moveSlab(dst, src);
+}
+/*
+* Big-O: O(1)
+*
+* This function moves every item of src onto the front of dst, leaving src empty. Like concatList, it only relinks the ends of the chain of src
+and moves its blocks to dst.
+*/
+void spliceList(LIST *dst, LIST *src){
+    assert(dst != NULL && src != NULL && dst != src);
+    if(src -> count == 0){
+        return;
+    }
+    src -> head -> prev -> next = dst -> head -> next;
+    src -> head -> next -> prev = dst -> head;
+    dst -> head -> next -> prev = src -> head -> prev;
+    dst -> head -> next = src -> head -> next;
+    src -> head -> next = src -> head;
+    src -> head -> prev = src -> head;
+    dst -> count += src -> count;
+    src -> count = 0;
+    moveSlab(dst, src);
+}
+/*
 * Big-O: O(n)
 *
 * This function gets all the elements in the list and places it in the items array.
@@ -225,4 +391,14 @@ void *getItems(LIST *lp){
         temp = temp -> next;
     }
     return items;
+}
+/*
+* Big-O: O(1)
+*
+* This function returns the # of bytes allocated for the list, which is the list struct, the dummy node, and every block of the slab.
+* Since the blocks are handed out a node at a time, this counts the nodes that are free or not handed out yet too.
+*/
+long listBytes(LIST *lp){
+    assert(lp != NULL);
+    return sizeof(struct list) + sizeof(struct node) + lp -> bytes;
 }
\ No newline at end of file
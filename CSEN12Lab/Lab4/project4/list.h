@@ -7,7 +7,8 @@
  *		declarations for a list abstract data type for generic
  *		pointer types.  The list supports deque operations, in
  *		which items can be easily added to or removed from the
- *		front or rear of the list.
+ *		front or rear of the list.  The items of one list can also
+ *		be moved onto either end of another all at once.
  */
 
 # ifndef LIST_H
@@ -39,4 +40,10 @@ extern void *findItem(LIST *lp, void *item);
 
 extern void *getItems(LIST *lp);
 
+extern void concatList(LIST *dst, LIST *src);
+
+extern void spliceList(LIST *dst, LIST *src);
+
+extern long listBytes(LIST *lp);
+
 # endif /* LIST_H */
@@ -16,6 +16,7 @@
 # include <stdlib.h>
 # include <string.h>
 # include "set.h"
+# include "tokens.h"
 
 
 /* This is sufficient for the test cases in /scratch/coen12. */
@@ -49,8 +50,8 @@ static unsigned strhash(char *s)
 
 int main(int argc, char *argv[])
 {
-    FILE *fp;
-    char buffer[BUFSIZ], *word;
+    TOKENS *tp;
+    char *buffer, *word;
     SET *odd;
     int words;
 
@@ -62,7 +63,7 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
 
-    if ((fp = fopen(argv[1], "r")) == NULL) {
+    if ((tp = openTokens(argv[1])) == NULL) {
         fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
         exit(EXIT_FAILURE);
     }
@@ -73,7 +74,7 @@ int main(int argc, char *argv[])
     words = 0;
     odd = createSet(MAX_SIZE, strcmp, strhash);
 
-    while (fscanf(fp, "%s", buffer) == 1) {
+    while ((buffer = nextToken(tp, NULL)) != NULL) {
         words ++;
 
         if ((word = findElement(odd, buffer)) != NULL) {
@@ -85,7 +86,7 @@ int main(int argc, char *argv[])
 
     printf("%d total words\n", words);
     printf("%d words occur an odd number of times\n", numElements(odd));
-    fclose(fp);
+    closeTokens(tp);
 
     destroySet(odd);
     exit(EXIT_SUCCESS);
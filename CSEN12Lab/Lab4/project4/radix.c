@@ -3,97 +3,1143 @@
  *
  * Copyright:	2021, Darren C. Atkinson
  *
- * Description:	Read a sequence of non-negative integers from the
- *		standard input and sort then using radix sort.  Each
- *		integer in the list is dropped into a bucket by its least
- *		significant digit.  After all integers are placed in
- *		buckets, the buckets are copied back into the list and we
- *		repeat the process, but with the next most significant
- *		digit.  After all digits have been processed, the list is
- *		sorted!  Since the buckets need to preserve the order of
- *		insertion, we need to implement a queue.  A list provides
- *		this functionality for us.  The algorithm can be found at
+ * Description:	Read a sequence of integers from the standard input and
+ *		sort then using radix sort.  The
+ *		integers are read into an array and sorted one 8-bit digit
+ *		at a time, starting with the least significant digit.  Each
+ *		pass counts how many integers have each value of the digit,
+ *		sums the counts to find where the integers with each value
+ *		start, and copies the integers into a second array at those
+ *		places.  Since the copy keeps integers with the same digit
+ *		in the order they were in, after the pass for the most
+ *		significant digit the array is sorted!  The two arrays
+ *		trade places after every pass.  The counts for every digit
+ *		are taken in a single pass over the input, and a pass is
+ *		skipped when all integers have the same value for its
+ *		digit.  The algorithm can be found at
  *		wikipedia.org/wiki/Radix_sort.
+ *
+ *		With -j N, the array is cut into N slices that are sorted
+ *		on N threads at once.  For each pass every thread counts
+ *		its own slice, and then works out from the counts of all
+ *		of the slices where the integers of its slice go: after
+ *		all integers with smaller digits, and after the integers
+ *		with the same digit in the slices before it.  The threads
+ *		then copy into places that no other thread uses, so they
+ *		need no locks, and the result is the same as sorting on
+ *		one thread.
+ *
+ *		Negative integers are sorted by flipping the sign bit of
+ *		each integer, which puts the negative integers below the
+ *		others when the bits are sorted as an unsigned integer.
+ *		The integers are 32 bits wide if they all fit in an int and
+ *		64 bits wide otherwise, and the width is what sets the
+ *		number of passes.  Since scanf and printf take longer than
+ *		the sort itself, the integers are read and written by hand
+ *		through buffers.
+ *
+ *		With -m, no more than a given number of bytes is used to
+ *		hold the integers.  The input is sorted in runs that fit,
+ *		each run is written to a temporary file, and the runs are
+ *		merged to the standard output.
+ *
+ *		With --binary, the input and output are arrays of raw
+ *		little-endian unsigned 32-bit integers, or 64-bit integers
+ *		with --binary=64, instead of text.  If a file is given it
+ *		is mapped into memory and its integers are copied into the
+ *		array, so the file is never changed.
  */
 
-# include <math.h>
 # include <stdio.h>
 # include <stdlib.h>
+# include <stdint.h>
+# include <stdbool.h>
+# include <string.h>
 # include <assert.h>
-# include "list.h"
+# include <limits.h>
+# include <unistd.h>
+# include <fcntl.h>
+# include <endian.h>
+# include <pthread.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# ifdef RADIXSTATS
+# include <time.h>
+# endif
+
+# define BITS	8			/* bits in each digit          */
+# define RADIX	(1 << BITS)		/* values of each digit        */
+# define MAX_DIGITS (64 / BITS)		/* digits in widest integer    */
+# define MAX_THREADS 256			/* most threads for -j         */
+# define BUFSIZE 65536			/* bytes in each I/O buffer    */
+# define MAX_FANIN 256			/* most runs merged at once    */
+# define MIN_KEYS 64			/* fewest keys in merge buffer */
+# define MIN_BUDGET 4096			/* fewest bytes for -m         */
+
+struct sort {
+    uint64_t *a;			/* array being sorted          */
+    uint64_t *b;			/* second array                */
+    size_t n;				/* number of integers          */
+    int digits;				/* digits in each integer      */
+    int threads;			/* number of slices            */
+    struct slice *slices;		/* slice of each thread        */
+    pthread_barrier_t barrier;		/* waits for every thread      */
+};
+
+struct slice {
+    struct sort *sp;			/* sort this slice is part of  */
+    int id;				/* number of this slice        */
+    size_t first;			/* first integer in slice      */
+    size_t last;			/* one past last integer       */
+    uint64_t diff;			/* bits that differ from a[0]  */
+    size_t counts[RADIX];		/* counts of the current digit */
+};
 
-# define r 10
+struct run {
+    FILE *fp;				/* file holding the run        */
+    uint64_t *keys;			/* keys read from the file     */
+    size_t next;			/* next key in buffer          */
+    size_t length;			/* keys in buffer              */
+};
+
+
+static char input[BUFSIZE], output[BUFSIZE];
+static size_t inputNext, inputLength, outputLength;
+static int binary;			/* width of raw integers, or 0 */
+
+static const char pairs[] =
+    "00010203040506070809101112131415161718192021222324"
+    "25262728293031323334353637383940414243444546474849"
+    "50515253545556575859606162636465666768697071727374"
+    "75767778798081828384858687888990919293949596979899";
 
 
 /*
- * Function:	main
+ * Function:	readChar
  *
- * Description:	Driver function for the radix application.
+ * Description:	Return the next character on the standard input, or EOF
+ *		if there are no more, refilling the input buffer when it
+ *		runs out.
+ */
+
+static inline int readChar(void)
+{
+    if (inputNext == inputLength) {
+	inputLength = fread(input, 1, BUFSIZE, stdin);
+	inputNext = 0;
+
+	if (inputLength == 0)
+	    return EOF;
+    }
+
+    return (unsigned char) input[inputNext ++];
+}
+
+
+/*
+ * Function:	readNumber
+ *
+ * Description:	Read the next integer on the standard input into *XP and
+ *		return true, or return false if the input does not start
+ *		with an integer once any white space is skipped.  Like
+ *		scanf, reading stops at the first character after the
+ *		digits and leaves it to be read next, so "12-5" holds two
+ *		integers but the rest of a word such as "12ab" is not an
+ *		integer and ends the input.
+ */
+
+static bool readNumber(int64_t *xp)
+{
+    uint64_t value, limit;
+    bool negative;
+    int c, digit;
+
+
+    do
+	c = readChar();
+    while (c == ' ' || (c >= '\t' && c <= '\r'));
+
+    negative = c == '-';
+
+    if (c == '-' || c == '+')
+	c = readChar();
+
+    if (c < '0' || c > '9')
+	return false;
+
+    value = 0;
+    limit = negative ? (uint64_t) INT64_MAX + 1 : INT64_MAX;
+
+    do {
+	digit = c - '0';
+
+	if (value > (limit - digit) / 10) {
+	    fprintf(stderr, "Sorry, only 64-bit values allowed.\n");
+	    exit(EXIT_FAILURE);
+	}
+
+	value = value * 10 + digit;
+	c = readChar();
+    } while (c >= '0' && c <= '9');
+
+    if (c != EOF)
+	inputNext --;
+
+    *xp = negative ? (int64_t) (0 - value) : (int64_t) value;
+    return true;
+}
+
+
+/*
+ * Function:	flushOutput
+ *
+ * Description:	Write out everything in the output buffer.
+ */
+
+static void flushOutput(void)
+{
+    if (fwrite(output, 1, outputLength, stdout) != outputLength) {
+	perror("radix");
+	exit(EXIT_FAILURE);
+    }
+
+    outputLength = 0;
+}
+
+
+/*
+ * Function:	writeNumber
+ *
+ * Description:	Write the integer X and a newline to the output buffer.
+ *		The digits are made two at a time from the table of pairs,
+ *		starting at the right.
+ */
+
+static void writeNumber(int64_t x)
+{
+    char digits[20], *p;
+    uint64_t value;
+
+
+    if (outputLength > BUFSIZE - 22)
+	flushOutput();
+
+    if (x < 0) {
+	output[outputLength ++] = '-';
+	value = 0 - (uint64_t) x;
+    } else
+	value = x;
+
+    p = digits + sizeof(digits);
+
+    while (value >= 100) {
+	p -= 2;
+	memcpy(p, pairs + value % 100 * 2, 2);
+	value /= 100;
+    }
+
+    if (value >= 10) {
+	p -= 2;
+	memcpy(p, pairs + value * 2, 2);
+    } else
+	*-- p = '0' + value;
+
+    memcpy(output + outputLength, p, digits + sizeof(digits) - p);
+    outputLength += digits + sizeof(digits) - p;
+    output[outputLength ++] = '\n';
+}
+
+
+/*
+ * Function:	readRun
+ *
+ * Description:	Read up to LENGTH integers on the standard input into A
+ *		and return how many were read.  If any of them does not fit
+ *		in an int, *NARROWP is set to false.
+ */
+
+static size_t readRun(int64_t *a, size_t length, bool *narrowp)
+{
+    size_t n;
+    int64_t x;
+
+
+    for (n = 0; n < length && readNumber(&x); n ++) {
+	if (x < INT32_MIN || x > INT32_MAX)
+	    *narrowp = false;
+
+	a[n] = x;
+    }
+
+    return n;
+}
+
+
+/*
+ * Function:	readRecords
+ *
+ * Description:	Read up to LENGTH raw integers that are WIDTH bits wide on
+ *		the standard input into A and return how many were read.
+ *		The integers are read packed into the front of A and then
+ *		spread out to 64 bits, starting from the end so that none
+ *		is overwritten before it is moved.
+ */
+
+static size_t readRecords(uint64_t *a, size_t length, int width)
+{
+    size_t size, bytes, n, i;
+    uint32_t x;
+
+
+    size = width / 8;
+    bytes = fread(a, 1, size * length, stdin);
+
+    if (ferror(stdin)) {
+	perror("radix");
+	exit(EXIT_FAILURE);
+    }
+
+    if (bytes % size != 0) {
+	fprintf(stderr, "Sorry, input must be whole %d-bit values.\n", width);
+	exit(EXIT_FAILURE);
+    }
+
+    n = bytes / size;
+
+    for (i = n; i > 0; i --)
+	if (width == 32) {
+	    memcpy(&x, (char *) a + (i - 1) * size, size);
+	    a[i - 1] = le32toh(x);
+	} else
+	    a[i - 1] = le64toh(a[i - 1]);
+
+    return n;
+}
+
+
+/*
+ * Function:	makeKeys
+ *
+ * Description:	Turn the N integers in A into keys that are WIDTH bits
+ *		wide by flipping their sign bits, so that the keys sort as
+ *		unsigned integers in the same order as the integers.
  */
 
-int main(void)
+static void makeKeys(uint64_t *a, size_t n, int width)
 {
-    int i, x, niter, div, max, *p;
-    LIST *a, *lists[r];
+    size_t i;
 
 
-    max = 0;
-    a = createList(NULL);
+    for (i = 0; i < n; i ++)
+	if (width == 32)
+	    a[i] = (uint32_t) a[i] ^ (uint32_t) 1 << 31;
+	else
+	    a[i] = a[i] ^ (uint64_t) 1 << 63;
+}
+
+
+/*
+ * Function:	readKeys
+ *
+ * Description:	Read the integers on the standard input into an array of
+ *		keys, which is doubled in size as it fills up, and return
+ *		it, storing the number of keys in *NP and their width in
+ *		bits in *WIDTHP.  Raw integers are already keys.
+ */
+
+static uint64_t *readKeys(size_t *np, int *widthp)
+{
+    size_t n, length;
+    bool narrow;
+    int64_t *a;
+
+
+    n = 0;
+    length = 512;
+    a = NULL;
+    narrow = true;
+
+    do {
+	length *= 2;
+	a = realloc(a, sizeof(int64_t) * length);
+	assert(a != NULL);
+
+	if (binary)
+	    n += readRecords((uint64_t *) a + n, length - n, binary);
+	else
+	    n += readRun(a + n, length - n, &narrow);
+    } while (n == length);
+
+    *np = n;
+
+    if (binary)
+	*widthp = binary;
+    else {
+	*widthp = narrow ? 32 : 64;
+	makeKeys((uint64_t *) a, n, *widthp);
+    }
+
+    return (uint64_t *) a;
+}
+
+
+/*
+ * Function:	mapKeys
+ *
+ * Description:	Copy the raw integers in the file PATH into an array of
+ *		keys and return it, storing the number of keys in *NP.
+ *		The file is mapped into memory rather than read.  If it
+ *		cannot be mapped, such as when it is a pipe, it is read
+ *		like the standard input instead.
+ */
+
+static uint64_t *mapKeys(char *path, size_t *np)
+{
+    size_t size, n, i;
+    struct stat st;
+    uint64_t *a, x;
+    int fd, width;
+    uint32_t y;
+    char *data;
+
 
-    for (i = 0; i < r; i ++)
-	lists[i] = createList(NULL);
+    if ((fd = open(path, O_RDONLY)) == -1) {
+	perror(path);
+	exit(EXIT_FAILURE);
+    }
+
+    size = binary / 8;
+    data = MAP_FAILED;
 
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+	data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
 
-    /* Read in the numbers and record the maximum as we go along. */
+    if (data == MAP_FAILED) {
+	close(fd);
 
-    while (scanf("%d", &x) == 1) {
-	if (x >= 0) {
-	    p = malloc(sizeof(int));
-	    assert(p != NULL);
-	    *p = x;
+	if (freopen(path, "r", stdin) == NULL) {
+	    perror(path);
+	    exit(EXIT_FAILURE);
+	}
 
-	    addLast(a, p);
+	return readKeys(np, &width);
+    }
+
+    if (st.st_size % size != 0) {
+	fprintf(stderr, "Sorry, input must be whole %d-bit values.\n", binary);
+	exit(EXIT_FAILURE);
+    }
 
-	    if (x > max)
-		max = x;
+    madvise(data, st.st_size, MADV_SEQUENTIAL);
+    n = st.st_size / size;
+    a = malloc(sizeof(uint64_t) * n);
+    assert(a != NULL);
 
+    for (i = 0; i < n; i ++)
+	if (binary == 32) {
+	    memcpy(&y, data + i * size, size);
+	    a[i] = le32toh(y);
 	} else {
-	    fprintf(stderr, "Sorry, only non-negative values allowed.\n");
+	    memcpy(&x, data + i * size, size);
+	    a[i] = le64toh(x);
+	}
+
+    munmap(data, st.st_size);
+    close(fd);
+
+    *np = n;
+    return a;
+}
+
+
+/*
+ * Function:	writeKey
+ *
+ * Description:	Write the KEY that is WIDTH bits wide to the output
+ *		buffer, either raw or as an integer on a line with its sign
+ *		bit flipped back.
+ */
+
+static inline void writeKey(uint64_t key, int width)
+{
+    uint32_t x;
+
+
+    if (binary) {
+	if (outputLength > BUFSIZE - sizeof(uint64_t))
+	    flushOutput();
+
+	if (width == 32) {
+	    x = htole32(key);
+	    memcpy(output + outputLength, &x, sizeof(x));
+	} else {
+	    key = htole64(key);
+	    memcpy(output + outputLength, &key, sizeof(key));
+	}
+
+	outputLength += width / 8;
+
+    } else if (width == 32)
+	writeNumber((int32_t) (uint32_t) (key ^ (uint32_t) 1 << 31));
+    else
+	writeNumber((int64_t) (key ^ (uint64_t) 1 << 63));
+}
+
+
+/*
+ * Function:	writeKeys
+ *
+ * Description:	Write the N keys in A that are WIDTH bits wide to the
+ *		standard output.
+ */
+
+static void writeKeys(uint64_t *a, size_t n, int width)
+{
+    size_t i;
+
+
+    for (i = 0; i < n; i ++)
+	writeKey(a[i], width);
+
+    flushOutput();
+}
+
+
+/*
+ * Function:	radixSort
+ *
+ * Description:	Sort the N integers in A that have the given number of
+ *		DIGITS using B as the second array and return whichever of
+ *		the two holds the sorted integers.
+ */
+
+static uint64_t *radixSort(uint64_t *a, uint64_t *b, size_t n, int digits)
+{
+    size_t counts[MAX_DIGITS][RADIX], sum, count, i;
+    int d, shift, digit;
+    uint64_t *t;
+
+
+    /* Count the values of every digit at once. */
+
+    memset(counts, 0, sizeof(counts));
+
+    for (i = 0; i < n; i ++)
+	for (d = 0; d < digits; d ++)
+	    counts[d][a[i] >> d * BITS & (RADIX - 1)] ++;
+
+    for (d = 0; d < digits; d ++) {
+	shift = d * BITS;
+
+
+	/* Skip the pass if every integer has the same digit. */
+
+	if (n == 0 || counts[d][a[0] >> shift & (RADIX - 1)] == n)
+	    continue;
+
+
+	/* Turn the counts into the starting place of each value. */
+
+	for (sum = 0, digit = 0; digit < RADIX; digit ++) {
+	    count = counts[d][digit];
+	    counts[d][digit] = sum;
+	    sum += count;
+	}
+
+
+	/* Copy the integers into place and trade the arrays. */
+
+	for (i = 0; i < n; i ++)
+	    b[counts[d][a[i] >> shift & (RADIX - 1)] ++] = a[i];
+
+	t = a;
+	a = b;
+	b = t;
+    }
+
+    return a;
+}
+
+
+/*
+ * Function:	sortSlice
+ *
+ * Description:	Sort the slice pointed to by ARG along with the other
+ *		slices.  This is the function that each thread runs.  The
+ *		threads wait for each other after the counts are taken and
+ *		after the integers are copied, so no thread reads counts or
+ *		integers that another thread is still changing.
+ */
+
+static void *sortSlice(void *arg)
+{
+    struct slice *me = arg, *slices;
+    struct sort *sp = me->sp;
+    size_t places[RADIX], sum, i;
+    int d, t, shift, digit;
+    uint64_t *a, *b, *x, diff;
+
+
+    a = sp->a;
+    b = sp->b;
+    slices = sp->slices;
+
+
+    /* Find the bits that are not the same in every integer. */
+
+    for (diff = 0, i = me->first; i < me->last; i ++)
+	diff |= a[i] ^ a[0];
+
+    me->diff = diff;
+    pthread_barrier_wait(&sp->barrier);
+
+    for (diff = 0, t = 0; t < sp->threads; t ++)
+	diff |= slices[t].diff;
+
+    for (d = 0; d < sp->digits; d ++) {
+	shift = d * BITS;
+
+	if ((diff >> shift & (RADIX - 1)) == 0)
+	    continue;
+
+
+	/* Count the values of the digit in this slice. */
+
+	memset(me->counts, 0, sizeof(me->counts));
+
+	for (i = me->first; i < me->last; i ++)
+	    me->counts[a[i] >> shift & (RADIX - 1)] ++;
+
+	pthread_barrier_wait(&sp->barrier);
+
+
+	/* Find where the integers of this slice with each value start. */
+
+	for (sum = 0, digit = 0; digit < RADIX; digit ++)
+	    for (t = 0; t < sp->threads; t ++) {
+		if (t == me->id)
+		    places[digit] = sum;
+
+		sum += slices[t].counts[digit];
+	    }
+
+
+	/* Copy the integers into place and trade the arrays. */
+
+	for (i = me->first; i < me->last; i ++)
+	    b[places[a[i] >> shift & (RADIX - 1)] ++] = a[i];
+
+	pthread_barrier_wait(&sp->barrier);
+
+	x = a;
+	a = b;
+	b = x;
+    }
+
+    if (me->id == 0)
+	sp->a = a;
+
+    return NULL;
+}
+
+
+/*
+ * Function:	parallelSort
+ *
+ * Description:	Sort the N integers in A that have the given number of
+ *		DIGITS on THREADS threads using B as the second array and
+ *		return whichever of the two holds the sorted integers.  The
+ *		first slice is sorted on the calling thread.
+ */
+
+static uint64_t *parallelSort(uint64_t *a, uint64_t *b, size_t n, int digits,
+    int threads)
+{
+    pthread_t ids[MAX_THREADS];
+    struct sort s;
+    int t;
+
+
+    if ((size_t) threads > n)
+	threads = n > 0 ? n : 1;
+
+    if (threads == 1)
+	return radixSort(a, b, n, digits);
+
+    s.a = a;
+    s.b = b;
+    s.n = n;
+    s.digits = digits;
+    s.threads = threads;
+    s.slices = malloc(sizeof(struct slice) * threads);
+    assert(s.slices != NULL);
+    pthread_barrier_init(&s.barrier, NULL, threads);
+
+    for (t = 0; t < threads; t ++) {
+	s.slices[t].sp = &s;
+	s.slices[t].id = t;
+	s.slices[t].first = n / threads * t;
+	s.slices[t].last = t == threads - 1 ? n : n / threads * (t + 1);
+    }
+
+    for (t = 1; t < threads; t ++)
+	if (pthread_create(&ids[t], NULL, sortSlice, &s.slices[t]) != 0) {
+	    fprintf(stderr, "cannot create thread\n");
 	    exit(EXIT_FAILURE);
 	}
+
+    sortSlice(&s.slices[0]);
+
+    for (t = 1; t < threads; t ++)
+	pthread_join(ids[t], NULL);
+
+    pthread_barrier_destroy(&s.barrier);
+    free(s.slices);
+    return s.a;
+}
+
+
+/*
+ * Function:	createSpill
+ *
+ * Description:	Create and return a temporary file for a run in the
+ *		directory named by TMPDIR, or /tmp.  The file is removed
+ *		at once, so it goes away when it is closed.
+ */
+
+static FILE *createSpill(void)
+{
+    char path[PATH_MAX], *dir;
+    FILE *fp;
+    int fd;
+
+
+    dir = getenv("TMPDIR");
+
+    if (dir == NULL || *dir == '\0')
+	dir = "/tmp";
+
+    snprintf(path, sizeof(path), "%s/radixXXXXXX", dir);
+
+    if ((fd = mkstemp(path)) < 0 || (fp = fdopen(fd, "w+")) == NULL) {
+	perror(path);
+	exit(EXIT_FAILURE);
+    }
+
+    unlink(path);
+    setvbuf(fp, NULL, _IONBF, 0);
+    return fp;
+}
+
+
+/*
+ * Function:	writeSpill
+ *
+ * Description:	Write the N keys in A to the file FP.
+ */
+
+static void writeSpill(FILE *fp, uint64_t *a, size_t n)
+{
+    if (fwrite(a, sizeof(uint64_t), n, fp) != n) {
+	perror("radix");
+	exit(EXIT_FAILURE);
+    }
+}
+
+
+/*
+ * Function:	refill
+ *
+ * Description:	Read up to SIZE more keys of the run pointed to by RP into
+ *		its buffer.  The buffer is empty if the run has no more.
+ */
+
+static void refill(struct run *rp, size_t size)
+{
+    rp->next = 0;
+    rp->length = fread(rp->keys, sizeof(uint64_t), size, rp->fp);
+
+    if (ferror(rp->fp)) {
+	perror("radix");
+	exit(EXIT_FAILURE);
+    }
+}
+
+
+/*
+ * Function:	beats
+ *
+ * Description:	Return whether the next key of run I comes before the next
+ *		key of run J.  A run with no more keys never comes first.
+ */
+
+static inline bool beats(struct run *runs, int i, int j)
+{
+    if (runs[i].length == 0)
+	return false;
+
+    if (runs[j].length == 0)
+	return true;
+
+    return runs[i].keys[runs[i].next] < runs[j].keys[runs[j].next];
+}
+
+
+/*
+ * Function:	mergeRuns
+ *
+ * Description:	Merge the K runs in the files FILES and close them.  The
+ *		keys are written to the file OUT, or as integers to the
+ *		standard output if OUT is NULL.  The runs are merged with a
+ *		tournament tree of losers: the leaves are the runs, each
+ *		inner node holds the run that lost the match there, and
+ *		the winner is the run with the smallest key.  After the
+ *		winner gives up its key, only the matches on the path from
+ *		its leaf to the root are played again, so each key takes
+ *		log k comparisons.  The buffers for the runs and the output
+ *		split the BUDGET bytes between them, but none is smaller
+ *		than MIN_KEYS keys, so each read of a run brings in a block
+ *		of keys rather than one at a time.
+ */
+
+static void mergeRuns(FILE **files, int k, FILE *out, size_t budget)
+{
+    int *losers, *winners, node, w, t, i;
+    size_t size, length;
+    uint64_t *buffer, key;
+    struct run *runs;
+
+
+    size = budget / sizeof(uint64_t) / (k + 1);
+    size = size > MIN_KEYS ? size : MIN_KEYS;
+
+    runs = malloc(sizeof(struct run) * k);
+    buffer = malloc(sizeof(uint64_t) * size);
+    losers = malloc(sizeof(int) * k * 2);
+    winners = malloc(sizeof(int) * k * 2);
+    assert(runs != NULL && buffer != NULL);
+    assert(losers != NULL && winners != NULL);
+
+    for (i = 0; i < k; i ++) {
+	runs[i].fp = files[i];
+	runs[i].keys = malloc(sizeof(uint64_t) * size);
+	assert(runs[i].keys != NULL);
+	rewind(files[i]);
+	refill(&runs[i], size);
+	winners[k + i] = i;
+    }
+
+
+    /* Play the first matches from the leaves up. */
+
+    for (node = k - 1; node >= 1; node --)
+	if (beats(runs, winners[2 * node], winners[2 * node + 1])) {
+	    winners[node] = winners[2 * node];
+	    losers[node] = winners[2 * node + 1];
+	} else {
+	    winners[node] = winners[2 * node + 1];
+	    losers[node] = winners[2 * node];
+	}
+
+    w = k > 1 ? winners[1] : 0;
+
+
+    /* Take the key of the winner and replay its path. */
+
+    length = 0;
+
+    while (runs[w].length > 0) {
+	key = runs[w].keys[runs[w].next ++];
+
+	if (out == NULL)
+	    writeKey(key, binary ? binary : 64);
+	else {
+	    buffer[length ++] = key;
+
+	    if (length == size) {
+		writeSpill(out, buffer, length);
+		length = 0;
+	    }
+	}
+
+	if (runs[w].next == runs[w].length)
+	    refill(&runs[w], size);
+
+	for (node = (w + k) / 2; node >= 1; node /= 2)
+	    if (beats(runs, losers[node], w)) {
+		t = losers[node];
+		losers[node] = w;
+		w = t;
+	    }
     }
 
-    div = 1;
-    niter = ceil(log(max + 1) / log(r));
+    if (out == NULL)
+	flushOutput();
+    else
+	writeSpill(out, buffer, length);
+
+    for (i = 0; i < k; i ++) {
+	fclose(runs[i].fp);
+	free(runs[i].keys);
+    }
+
+    free(runs);
+    free(buffer);
+    free(losers);
+    free(winners);
+}
+
+
+/*
+ * Function:	fanIn
+ *
+ * Description:	Return how many runs to merge at once with BUDGET bytes,
+ *		which is as many as fit when each run and the output have
+ *		a buffer of MIN_KEYS keys, but at least 2 and no more than
+ *		MAX_FANIN.
+ */
+
+static int fanIn(size_t budget)
+{
+    size_t k;
+
+
+    k = budget / (MIN_KEYS * sizeof(uint64_t));
+
+    if (k < 3)
+	return 2;
+
+    return k - 1 < MAX_FANIN ? k - 1 : MAX_FANIN;
+}
 
-    while (niter --) {
 
+/*
+ * Function:	externalSort
+ *
+ * Description:	Sort the integers on the standard input using no more
+ *		than about BUDGET bytes of memory.  The input is read in
+ *		runs that fill half of the budget, since sorting a run
+ *		takes a second array as big.  Each run is sorted on
+ *		THREADS threads and written to a temporary file, and the
+ *		runs are then merged, as many at a time as fanIn allows,
+ *		until they can all be merged at once to the standard
+ *		output.  The width of text keys is not known until all of
+ *		the input has been read, so they are always 64 bits wide.
+ *		If the input fits in one run it is written out without a
+ *		file.
+ */
+
+static void externalSort(size_t budget, int threads)
+{
+    uint64_t *a, *b, *sorted;
+    size_t length, n;
+    int count, size, width, fanin;
+    FILE **files, *fp;
+    bool narrow;
 
-	/* Move the numbers from the list to the buckets. */
 
-	while (numItems(a) > 0) {
-	    p = removeFirst(a);
-	    addLast(lists[*p / div % r], p);
+    length = budget / (2 * sizeof(uint64_t));
+    a = malloc(sizeof(uint64_t) * length);
+    b = malloc(sizeof(uint64_t) * length);
+    assert(a != NULL && b != NULL);
+
+    files = NULL;
+    count = size = 0;
+    width = binary ? binary : 64;
+
+
+    /* Sort each run and write it out. */
+
+    do {
+	if (binary)
+	    n = readRecords(a, length, binary);
+	else {
+	    n = readRun((int64_t *) a, length, &narrow);
+	    makeKeys(a, n, width);
 	}
 
+	sorted = parallelSort(a, b, n, width / BITS, threads);
 
-	/* Move the numbers from the buckets back into the list. */
+	if (count == 0 && n < length) {
+	    writeKeys(sorted, n, width);
+	    free(a);
+	    free(b);
+	    return;
+	}
 
-	for (i = 0; i < r; i ++)
-	    while (numItems(lists[i]) > 0)
-		addLast(a, removeFirst(lists[i]));
+	if (n > 0) {
+	    if (count == size) {
+		size = size > 0 ? size * 2 : MAX_FANIN;
+		files = realloc(files, sizeof(FILE *) * size);
+		assert(files != NULL);
+	    }
 
-	div = div * r;
+	    files[count ++] = fp = createSpill();
+	    writeSpill(fp, sorted, n);
+	}
+    } while (n == length);
+
+    free(a);
+    free(b);
+
+
+    /* Merge the runs into fewer, longer runs until there are few enough. */
+
+    fanin = fanIn(budget);
+
+    while (count > fanin) {
+	fp = createSpill();
+	mergeRuns(files, fanin, fp, budget);
+	count -= fanin;
+	memmove(files, files + fanin, sizeof(FILE *) * count);
+	files[count ++] = fp;
     }
 
+    mergeRuns(files, count, NULL, budget);
+    free(files);
+}
+
 
-    /* Print out the numbers. */
+/*
+ * Function:	parseSize
+ *
+ * Description:	Return the number of bytes given by the string S, which
+ *		may end with K, M, or G, or 0 if S is not a size.
+ */
+
+static size_t parseSize(char *s)
+{
+    unsigned long long size;
+    char *end;
+
+
+    size = strtoull(s, &end, 10);
+
+    if (end == s || *s == '-')
+	return 0;
+
+    if (*end == 'k' || *end == 'K')
+	size <<= 10, end ++;
+    else if (*end == 'm' || *end == 'M')
+	size <<= 20, end ++;
+    else if (*end == 'g' || *end == 'G')
+	size <<= 30, end ++;
+
+    return *end == '\0' ? size : 0;
+}
+
+
+/*
+ * Function:	main
+ *
+ * Description:	Driver function for the radix application.
+ */
+
+int main(int argc, char *argv[])
+{
+    uint64_t *a, *b, *sorted;
+    int threads, width, j;
+    size_t n, budget;
+    char *path;
+# ifdef RADIXSTATS
+    struct timespec start, end;
+# endif
+
+
+    /* Check usage. */
+
+    threads = 1;
+    budget = 0;
+    path = NULL;
+
+    for (j = 1; j < argc; j ++)
+	if (strcmp(argv[j], "-j") == 0 && j + 1 < argc) {
+	    threads = atoi(argv[++ j]);
+
+	    if (threads < 1 || threads > MAX_THREADS) {
+		fprintf(stderr, "%s: invalid thread count\n", argv[0]);
+		exit(EXIT_FAILURE);
+	    }
+
+	} else if (strcmp(argv[j], "-m") == 0 && j + 1 < argc) {
+	    budget = parseSize(argv[++ j]);
+
+	    if (budget < MIN_BUDGET) {
+		fprintf(stderr, "%s: invalid memory budget\n", argv[0]);
+		exit(EXIT_FAILURE);
+	    }
+
+	} else if (strcmp(argv[j], "--binary") == 0)
+	    binary = 32;
+
+	else if (strncmp(argv[j], "--binary=", 9) == 0) {
+	    binary = atoi(argv[j] + 9);
 
-    while (numItems(a) > 0) {
-	p = removeFirst(a);
-	printf("%d\n", *p);
-	free(p);
+	    if (binary != 32 && binary != 64) {
+		fprintf(stderr, "%s: binary width must be 32 or 64\n", argv[0]);
+		exit(EXIT_FAILURE);
+	    }
+
+	} else if (argv[j][0] != '-' && path == NULL)
+	    path = argv[j];
+
+	else {
+	    fprintf(stderr, "usage: %s [-j threads] [-m bytes] ", argv[0]);
+	    fprintf(stderr, "[--binary[=32|64]] [file]\n");
+	    exit(EXIT_FAILURE);
+	}
+
+    if (path != NULL && (!binary || budget > 0)) {
+	if (freopen(path, "r", stdin) == NULL) {
+	    perror(path);
+	    exit(EXIT_FAILURE);
+	}
+
+	path = NULL;
+    }
+
+
+    /* Sort through temporary files if there is a memory budget. */
+
+    if (budget > 0) {
+	externalSort(budget, threads);
+	exit(EXIT_SUCCESS);
     }
 
+
+    /* Read in the numbers. */
+
+    if (path != NULL) {
+	a = mapKeys(path, &n);
+	width = binary;
+    } else
+	a = readKeys(&n, &width);
+
+    b = malloc(sizeof(uint64_t) * (n > 0 ? n : 1));
+    assert(b != NULL);
+
+
+    /* Sort the numbers. */
+
+# ifdef RADIXSTATS
+    clock_gettime(CLOCK_MONOTONIC, &start);
+# endif
+
+    sorted = parallelSort(a, b, n, width / BITS, threads);
+
+# ifdef RADIXSTATS
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    fprintf(stderr, "threads %d\n", threads);
+    fprintf(stderr, "seconds %f\n", end.tv_sec - start.tv_sec +
+	(end.tv_nsec - start.tv_nsec) / 1e9);
+# endif
+
+
+    /* Print out the numbers. */
+
+    writeKeys(sorted, n, width);
+
+    free(a);
+    free(b);
     exit(EXIT_SUCCESS);
 }
@@ -0,0 +1,277 @@
+/*
+* File: ring.c - circular array deque
+* Author: theonelog
+* Lab Section: CSEN12L-1
+* Last Updated: 11/7/2024
+* Description: An implementation of list.h as a growable circular array instead of a linked list. The items of a list sit next to each
+other in one array that wraps around from the end back to the start, so adding or removing at either end only moves an index and a queue
+or stack walks memory in order. When the array fills up it is doubled. Its length is always a power of 2, so wrapping an index around is
+a mask instead of a division. It is a drop-in replacement for list.c for maze.c.
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "list.h"
+#include <assert.h>
+#define MIN_LENGTH 8 //the # of slots in the array of a new list
+/*
+* This is the list struct that defines all the data required for a list to be a list.
+*
+* The items are in data starting at index first and wrapping around past the end of the array. length is the # of slots in data, which is
+a power of 2, and count is the # of them in use. compare is kept as this is a generic list that works with any data type that is comparable.
+*/
+struct list{
+    int count;
+    int length;
+    int first;
+    void **data;
+    int (*compare)();
+};
+/*
+* Big-O: O(1)
+*
+* This function returns the index in data of the item at position i of the list, wrapping around past the end of the array.
+*/
+static inline int slot(LIST *lp, int i){
+    return (lp -> first + i) & (lp -> length - 1);
+}
+/*
+* Big-O: O(n)
+*
+* This function doubles the length of the array. The items are copied into the new array in order starting at index 0, as the part from first to
+the end of the old array and then the part that wrapped around to its start.
+*/
+static void grow(LIST *lp){
+    void **data = malloc(sizeof(void *) * lp -> length * 2);
+    int n = lp -> length - lp -> first;
+    assert(data != NULL);
+    if(n > lp -> count){
+        n = lp -> count;
+    }
+    memcpy(data, lp -> data + lp -> first, sizeof(void *) * n);
+    memcpy(data + n, lp -> data, sizeof(void *) * (lp -> count - n));
+    free(lp -> data);
+    lp -> data = data;
+    lp -> first = 0;
+    lp -> length *= 2;
+}
+/*
+* Big-O: O(1)
+*
+* This function creates and returns a list pointer.
+* It first mallocs for the list pointer and its array and then defines all the variables after asserting that they are not null.
+*/
+LIST *createList(int (*compare)()){
+    struct list *lp = malloc(sizeof(LIST));
+    assert(lp != NULL);
+    lp -> data = malloc(sizeof(void *) * MIN_LENGTH);
+    assert(lp -> data != NULL);
+    lp -> count = 0;
+    lp -> length = MIN_LENGTH;
+    lp -> first = 0;
+    lp -> compare = compare;
+    return lp;
+}
+/*
+* Big-O: O(1)
+*
+* This function frees the array and then the list pointer. Since the items are all in the one array, there is nothing to free one at a time.
+*/
+void destroyList(LIST *lp){
+    assert(lp != NULL);
+    free(lp -> data);
+    free(lp);
+}
+/*
+* Big-O: O(1)
+*
+* This function returns an integer which is the count of the amount of elements in the list.
+*/
+int numItems(LIST *lp){
+    assert(lp != NULL);
+    return lp -> count;
+}
+/*
+* Big-O: O(1) amortized
+*
+* This function adds an element to the front of the list by moving first back one slot, wrapping around to the end of the array if it was 0.
+* If the array is full it is doubled first, which is O(n) but only happens after n adds.
+*/
+void addFirst(LIST *lp, void *item){
+    assert(lp != NULL && item != NULL);
+    if(lp -> count == lp -> length){
+        grow(lp);
+    }
+    lp -> first = (lp -> first - 1) & (lp -> length - 1);
+    lp -> data[lp -> first] = item;
+    lp -> count++;
+}
+/*
+* Big-O: O(1) amortized
+*
+* This function adds an element to the end of the list, in the slot just after the last item. If the array is full it is doubled first.
+*/
+void addLast(LIST *lp, void *item){
+    assert(lp != NULL && item != NULL);
+    if(lp -> count == lp -> length){
+        grow(lp);
+    }
+    lp -> data[slot(lp, lp -> count)] = item;
+    lp -> count++;
+}
+/*
+* Big-O: O(1)
+*
+* This function removes the first element in the list by moving first forward one slot, and returns it.
+*/
+void *removeFirst(LIST *lp){
+    assert(lp != NULL);
+    if(lp -> count <= 0){return NULL;}
+    void *data = lp -> data[lp -> first];
+    lp -> first = slot(lp, 1);
+    lp -> count--;
+    return data;
+}
+/*
+* Big-O: O(1)
+*
+* This function removes the last element in the list and returns it. Only the count has to change.
+*/
+void *removeLast(LIST *lp){
+    assert(lp != NULL);
+    if(lp -> count <= 0){return NULL;}
+    lp -> count--;
+    return lp -> data[slot(lp, lp -> count)];
+}
+/*
+* Big-O: O(1)
+*
+* This function returns the data in the first element of the list, or NULL if it is empty.
+*/
+void *getFirst(LIST *lp){
+    assert(lp != NULL);
+    return lp -> count > 0 ? lp -> data[lp -> first] : NULL;
+}
+/*
+* Big-O: O(1)
+*
+* This function returns the last element in the list's data, or NULL if it is empty.
+*/
+void *getLast(LIST *lp){
+    assert(lp != NULL);
+    return lp -> count > 0 ? lp -> data[slot(lp, lp -> count - 1)] : NULL;
+}
+/*
+* Big-O: O(n)
+*
+* Since we are only given the item, we need to search for it. If it is found, the items after it are each moved back one slot to close the hole.
+*/
+void removeItem(LIST *lp, void *item){
+    assert(lp != NULL);
+    int i = 0;
+    while(i < lp -> count && lp -> compare(lp -> data[slot(lp, i)], item) != 0){
+        i++;
+    }
+    if(i < lp -> count){
+        for(; i < lp -> count - 1; i++){
+            lp -> data[slot(lp, i)] = lp -> data[slot(lp, i + 1)];
+        }
+        lp -> count--;
+    }
+}
+/*
+* Big-O: O(n)
+*
+* Since we do not know where the item is, we need to search for it. If it is found, the matching item is immediately returned.
+* If the item is not found, NULL is returned.
+*/
+void *findItem(LIST *lp, void *item){
+    assert(lp != NULL);
+    for(int i = 0; i < lp -> count; i++){
+        if(lp -> compare(lp -> data[slot(lp, i)], item) == 0){
+            return lp -> data[slot(lp, i)];
+        }
+    }
+    return NULL;
+}
+/*
+* Big-O: O(1) if dst is empty, O(m) otherwise
+*
+* This function moves every item of src onto the end of dst, leaving src empty. If dst is empty the two lists just trade arrays. Otherwise the
+m items of src have to be copied, since they are in a different array, but they are copied in order with no pointers to follow.
+*/
+void concatList(LIST *dst, LIST *src){
+    assert(dst != NULL && src != NULL && dst != src);
+    if(dst -> count == 0){
+        struct list temp = *dst;
+        dst -> data = src -> data;
+        dst -> length = src -> length;
+        dst -> first = src -> first;
+        dst -> count = src -> count;
+        src -> data = temp.data;
+        src -> length = temp.length;
+        src -> first = 0;
+        src -> count = 0;
+        return;
+    }
+    while(dst -> count + src -> count > dst -> length){
+        grow(dst);
+    }
+    for(int i = 0; i < src -> count; i++){
+        dst -> data[slot(dst, dst -> count + i)] = src -> data[slot(src, i)];
+    }
+    dst -> count += src -> count;
+    src -> count = 0;
+    src -> first = 0;
+}
+/*
+* Big-O: O(1) if dst is empty, O(m) otherwise
+*
+* This function moves every item of src onto the front of dst, leaving src empty. Like concatList, the lists trade arrays if dst is empty, and
+otherwise the items of src are copied into the slots before first, last one first.
+*/
+void spliceList(LIST *dst, LIST *src){
+    assert(dst != NULL && src != NULL && dst != src);
+    if(dst -> count == 0){
+        concatList(dst, src);
+        return;
+    }
+    while(dst -> count + src -> count > dst -> length){
+        grow(dst);
+    }
+    for(int i = src -> count - 1; i >= 0; i--){
+        dst -> first = (dst -> first - 1) & (dst -> length - 1);
+        dst -> data[dst -> first] = src -> data[slot(src, i)];
+    }
+    dst -> count += src -> count;
+    src -> count = 0;
+    src -> first = 0;
+}
+/*
+* Big-O: O(n)
+*
+* This function gets all the elements in the list and places it in the items array, copying the part of the array from first to the end
+and then the part that wrapped around to the start.
+* Since memory is allocated for the array and then it is returned to the user, the user must free the memory manually.
+*/
+void *getItems(LIST *lp){
+    assert(lp != NULL);
+    void **items = malloc(sizeof(void *) * lp -> count);
+    int n = lp -> length - lp -> first;
+    assert(items != NULL);
+    if(n > lp -> count){
+        n = lp -> count;
+    }
+    memcpy(items, lp -> data + lp -> first, sizeof(void *) * n);
+    memcpy(items + n, lp -> data, sizeof(void *) * (lp -> count - n));
+    return items;
+}
+/*
+* Big-O: O(1)
+*
+* This function returns the # of bytes allocated for the list, which is the list struct and its whole array, including the unused slots.
+*/
+long listBytes(LIST *lp){
+    assert(lp != NULL);
+    return sizeof(struct list) + (long) lp -> length * sizeof(void *);
+}
@@ -13,6 +13,11 @@
 #include <assert.h>
 #include <stdbool.h>
 #define MAX_CHAIN_LENGTH 20 //The max length each linked list in the array can be
+#ifdef SETSTATS
+#define STAT(x) (x)
+#else
+#define STAT(x)
+#endif
 /*
 * This is the set struct that defines all the elements that make up a set for a generics implementation.
 * The data includes a hash function pointer and a compare function pointer.
@@ -23,7 +28,35 @@ struct set{
     LIST **data;
     int (*compare)();
     unsigned (*hash)();
+#ifdef SETSTATS
+    struct setstats stats;
+#endif
 };
+#ifdef SETSTATS
+static SET *current; //The set whose search is running, so countCompare knows whose counter to bump
+/*
+* Big-O: O(1)
+*
+* The lists only know about the compare function they were created with, so when SETSTATS is defined each list is given this
+wrapper instead. It counts the call against the current set and then calls the real compare function.
+*/
+static int countCompare(void *a, void *b){
+    current -> stats.compares++;
+    return current -> compare(a, b);
+}
+/*
+* Big-O: O(1)
+*
+* This function counts one search that made probes calls to compare, adding it to the histogram and the longest probe length.
+*/
+static void record(SET *sp, long probes){
+    sp -> stats.searches++;
+    sp -> stats.probes[probes < SETSTATS_BUCKETS ? probes : SETSTATS_BUCKETS - 1]++;
+    if(probes > sp -> stats.maxProbe){
+        sp -> stats.maxProbe = probes;
+    }
+}
+#endif
 /*
 * Big-O: O(n)
 *
@@ -37,11 +70,16 @@ SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)()){
     sp -> length = maxElts/MAX_CHAIN_LENGTH;
     sp -> data = malloc(sizeof(LIST) * sp -> length);
     for(int i = 0; i < sp -> length; i++){
+#ifdef SETSTATS
+        sp -> data[i] = createList(countCompare);
+#else
         sp -> data[i] = createList(compare);
+#endif
     }
     sp -> count = 0; 
     sp -> hash = hash;
     sp -> compare = compare;
+    STAT(memset(&sp -> stats, 0, sizeof(sp -> stats)));
     return sp;   
 }  
 /*
@@ -60,6 +98,25 @@ void destroySet(SET *sp){
     free(sp);
 }
 /*
+* Big-O: O(n)
+*
+* This function hashes elt to find the list it belongs in, stores that index in *location, and returns the matching item from the
+list or NULL if there isn't one. Every public function goes through here so the instrumentation only has to be done once.
+*/
+static void *search(SET *sp, void *elt, int *location){
+    *location = sp -> hash(elt) % sp -> length;
+#ifdef SETSTATS
+    sp -> stats.hashes++;
+    current = sp;
+    long before = sp -> stats.compares;
+    void *item = findItem(sp -> data[*location], elt);
+    record(sp, sp -> stats.compares - before);
+    return item;
+#else
+    return findItem(sp -> data[*location], elt);
+#endif
+}
+/*
 * Big-O: O(1)
 *
 * This function has 1 operation which is returning sp -> count.
@@ -76,8 +133,8 @@ int numElements(SET *sp){
 */
 void addElement(SET *sp, void *elt){
     assert(sp != NULL && elt != NULL);
-    int location = sp -> hash(elt) % sp -> length;
-    void *item = findItem(sp -> data[location], elt);
+    int location;
+    void *item = search(sp, elt, &location);
     if(item == NULL){
         addLast(sp -> data[location], elt);
         sp -> count++;
@@ -93,8 +150,8 @@ void addElement(SET *sp, void *elt){
 */
 void removeElement(SET *sp, void *elt){
     assert(sp != NULL && elt != NULL);
-    int location = sp -> hash(elt) % sp -> length;
-    void *item = findItem(sp -> data[location], elt);
+    int location;
+    void *item = search(sp, elt, &location);
     if(item != NULL){
         removeItem(sp -> data[location], item);
         sp -> count--;  
@@ -109,8 +166,8 @@ void removeElement(SET *sp, void *elt){
 */
 void *findElement(SET *sp, void *elt){
     assert(sp != NULL && elt != NULL);
-    int location = sp -> hash(elt) % sp -> length;
-    void *element = findItem(sp -> data[location], elt);
+    int location;
+    void *element = search(sp, elt, &location);
     return element != NULL ? element : NULL;
 }
 /*
@@ -139,4 +196,38 @@ void *getElements(SET *sp){
         }
     }
     return elts;
-}
\ No newline at end of file
+}
+/*
+* Big-O: O(n)
+*
+* This function returns the # of items in the longest list, which is the most elements that a search can ever have to compare against.
+* A search walks its whole list when the element is not there, so with chaining the longest probe sequence is just the longest chain.
+*/
+int maxProbeLength(SET *sp){
+    assert(sp != NULL);
+    int longest = 0;
+    for(int i = 0; i < sp -> length; i++){
+        if(numItems(sp -> data[i]) > longest){
+            longest = numItems(sp -> data[i]);
+        }
+    }
+    return longest;
+}
+#ifdef SETSTATS
+/*
+* Big-O: O(n)
+*
+* This function copies the counters kept for the set into out. Chaining never leaves deleted slots behind and the array of lists is
+never resized, so tombstones and resizes are always 0. The bytes are the set and its array of lists plus what each list reports for itself,
+which includes the blocks of its slab.
+*/
+void getSetStats(SET *sp, struct setstats *out){
+    assert(sp != NULL && out != NULL);
+    *out = sp -> stats;
+    out -> tombstones = 0;
+    out -> bytes = sizeof(SET) + sp -> length * sizeof(LIST *);
+    for(int i = 0; i < sp -> length; i++){
+        out -> bytes += listBytes(sp -> data[i]);
+    }
+}
+#endif
@@ -28,4 +28,17 @@ void *findElement(SET *sp, void *elt);
 
 void *getElements(SET *sp);
 
+int maxProbeLength(SET *sp);
+
+
+/* Instrumentation, only compiled in when SETSTATS is defined. */
+
+# ifdef SETSTATS
+
+# include "setstats.h"
+
+void getSetStats(SET *sp, struct setstats *out);
+
+# endif /* SETSTATS */
+
 # endif /* SET_H */
@@ -0,0 +1,641 @@
+/*
+ * File:        sort.c
+ *
+ * Copyright:	2024, theonelog
+ *
+ * Description: This file contains the sorting routines shared by the set
+ *              implementations.  getElements returns the elements in
+ *              sorted order no matter how the set stores them.
+ *
+ *              Strings compared with strcmp are sorted by their
+ *              characters instead of by calls to the comparison function,
+ *              using radix sort on large groups and multikey quicksort on
+ *              smaller ones.  With multikey quicksort, the strings are split into those
+ *              whose next character is less than, equal to, or greater
+ *              than a pivot character, and only the strings that are equal
+ *              go on to compare the character after it.  Small groups of
+ *              strings are finished with insertion sort.  The algorithm
+ *              can be found at wikipedia.org/wiki/Multi-key_quicksort.
+ *
+ *              When compiled with PARALLEL_SORT, large arrays are sorted
+ *              by one thread per processor, or SORT_THREADS threads, which
+ *              are started the first time they are needed and then wait
+ *              for the next array between sorts.  Each thread sorts one
+ *              slice by itself, and then the sorted slices are merged in
+ *              pairs until one is left.  The output of each merge is split
+ *              evenly among all of the threads, and each thread finds
+ *              where its part starts in the two slices by binary search,
+ *              so every thread has the same amount of work in every round.
+ *              The slices are not sorted stably, so equal elements could
+ *              come out in a different order than on one thread; the
+ *              order is only the same because the elements of a set are
+ *              all distinct.
+ */
+
+# include <stdlib.h>
+# include <string.h>
+# include <stdbool.h>
+# include <assert.h>
+# include <time.h>
+# include "sort.h"
+# ifdef PARALLEL_SORT
+# include <pthread.h>
+# include <unistd.h>
+# endif
+
+# define CUTOFF 16		/* largest group for insertion sort */
+# define RADIX_CUTOFF 4096	/* largest group for multikey sort  */
+
+# ifdef PARALLEL_SORT
+# define PARALLEL_CUTOFF 65536	/* smallest array sorted in parallel */
+
+struct pool {
+    void **elts;		/* array being sorted               */
+    void **temp;		/* second array for the merges      */
+    int n;			/* number of elements               */
+    int (*compare)();		/* comparison function              */
+    int threads;		/* number of threads                */
+    int *slices;		/* first element of each slice      */
+    pthread_barrier_t barrier;	/* waits for every thread           */
+    pthread_mutex_t lock;	/* guards job and running           */
+    pthread_cond_t start;	/* signaled when a job is started   */
+    int job;			/* number of jobs started           */
+    bool running;		/* whether a job is being sorted    */
+};
+
+struct worker {
+    struct pool *pp;		/* pool the thread is part of       */
+    int id;			/* number of the thread             */
+};
+
+static struct pool pool;
+static struct worker *workers;
+static pthread_once_t started = PTHREAD_ONCE_INIT;
+# endif
+
+/*
+* Function: swap
+*
+* Complexity: O(1)
+*
+* Description: This function is a helper method that does swapping.
+*/
+static void swap(void **arr, int i1, int i2){
+    void *temp = arr[i1];
+    arr[i1] = arr[i2];
+    arr[i2] = temp;
+}
+/*
+* Function: parition
+* 
+* Complexity: O(n)
+* 
+* Description: This function partitions the array and makes sure each value is less than the pivot on the left or larger than the pivot
+* on the right. It then returns the index of the pivot for the quickSort_recurse to use.
+* The pivot point is selected randomly to reduce the amount of times the function runs in O(n^2) time. It is drawn with rand_r from
+* the seed of the caller, so threads sorting at the same time each use their own seed instead of sharing the state of rand.
+*/
+static int partition(void **arr, int (*compare)(), int lo, int hi, unsigned *seed){
+    int index = lo + rand_r(seed) % (hi - lo);
+    if(index != hi){
+        swap(arr, index, hi);
+    }
+    void *pivot = arr[hi];
+    int i = lo;
+    for(int j = lo; j < hi; j++){
+        if(compare(arr[j], pivot) <= 0){
+            swap(arr, i, j);
+            i++;
+        }
+    }
+    swap(arr, i, hi);
+    return i;
+}
+/*
+* Function:   quickSort_recurse
+*
+* Complexity: 
+*   Best/Avg Case: O(n log(n))
+*   Worst Case: O(n^2)   
+*
+* Description: This function does all the recursive quicksorting operations on the array. Since the pivot selection might be bad, 
+* the worst case is O(n^2).
+*/
+static void quickSort_recurse(void **arr, int (*compare)(), int lo, int hi, unsigned *seed){
+    if(lo < hi){
+        int pivot = partition(arr, compare, lo, hi, seed);
+        quickSort_recurse(arr, compare, lo, pivot - 1, seed);
+        quickSort_recurse(arr, compare, pivot + 1, hi, seed);
+    }
+}
+/*
+* Function:   quickSort
+*
+* Complexity: O(1)
+*
+* Description: The basic quicksort function that initializes the recursive loop. Made to allow for a simpler input (len) instead of 
+* a hi and lo. The seed for the pivots comes from the time and the address of the array, so each slice of a parallel sort gets a different one.
+*/
+static void quickSort(void **arr, int (*compare)(), int len){
+    unsigned seed = time(NULL) ^ (unsigned long) arr;
+    quickSort_recurse(arr, compare, 0, len - 1, &seed);
+}
+
+
+/*
+ * Function:	insertionSort
+ *
+ * Complexity:	O(n^2)
+ *
+ * Description:	Sort the N strings of STRS, which all have the same first
+ *		DEPTH characters, by the characters after them.
+ */
+
+static void insertionSort(char **strs, int n, int depth)
+{
+    int i, j;
+    char *s;
+
+
+    for (i = 1; i < n; i ++) {
+	s = strs[i];
+
+	for (j = i; j > 0 && strcmp(strs[j - 1] + depth, s + depth) > 0; j --)
+	    strs[j] = strs[j - 1];
+
+	strs[j] = s;
+    }
+}
+
+
+/*
+ * Function:	median
+ *
+ * Complexity:	O(1)
+ *
+ * Description:	Return the median of the three characters A, B, and C.
+ */
+
+static int median(int a, int b, int c)
+{
+    if (a < b)
+	return b < c ? b : (a < c ? c : a);
+
+    return a < c ? a : (b < c ? c : b);
+}
+
+
+/*
+ * Function:	multikeySort
+ *
+ * Complexity:	O(n logn + d) average case, where d is the number of
+ *		characters needed to tell the strings apart
+ *
+ * Description:	Sort the N strings of STRS, which all have the same first
+ *		DEPTH characters.  The strings are split into three groups
+ *		by their character at DEPTH, using the median of the first,
+ *		middle, and last as the pivot.  The groups that are less
+ *		and greater are sorted at the same depth, and the group that
+ *		is equal is sorted one character deeper by the loop, unless
+ *		the pivot is the null character and the group is done.
+ */
+
+static void multikeySort(char **strs, int n, int depth)
+{
+    int lt, gt, i, c, pivot;
+
+
+    while (n > CUTOFF) {
+	pivot = median((unsigned char) strs[0][depth],
+	    (unsigned char) strs[n / 2][depth],
+	    (unsigned char) strs[n - 1][depth]);
+
+	lt = 0;
+	gt = n - 1;
+	i = 0;
+
+	while (i <= gt) {
+	    c = (unsigned char) strs[i][depth];
+
+	    if (c < pivot)
+		swap((void **) strs, lt ++, i ++);
+	    else if (c > pivot)
+		swap((void **) strs, i, gt --);
+	    else
+		i ++;
+	}
+
+	multikeySort(strs, lt, depth);
+	multikeySort(strs + gt + 1, n - gt - 1, depth);
+
+	if (pivot == '\0')
+	    return;
+
+	strs += lt;
+	n = gt - lt + 1;
+	depth ++;
+    }
+
+    insertionSort(strs, n, depth);
+}
+
+
+/*
+ * Function:	radixSort
+ *
+ * Complexity:	O(n + d) average case, where d is the number of characters
+ *		needed to tell the strings apart
+ *
+ * Description:	Sort the N strings of STRS, which all have the same first
+ *		DEPTH characters, using TEMP for N strings and CHARS for N
+ *		characters as scratch space.  Each string is put into a
+ *		bucket by its character at DEPTH, which is read only once
+ *		and saved in CHARS, and the strings are copied back bucket
+ *		by bucket.  Each bucket is then sorted one character deeper,
+ *		except the bucket of strings that have ended.  Buckets that
+ *		are small are sorted with multikey quicksort instead.  If
+ *		all of the strings fall in one bucket, the loop goes on to
+ *		the next character without recursing.
+ */
+
+static void radixSort(char **strs, int n, int depth, char **temp,
+    unsigned char *chars)
+{
+    int counts[256], places[256], i, c, sum;
+
+
+    while (n > RADIX_CUTOFF) {
+	memset(counts, 0, sizeof(counts));
+
+	for (i = 0; i < n; i ++) {
+	    chars[i] = strs[i][depth];
+	    counts[chars[i]] ++;
+	}
+
+
+	/* If every string has the same character, just go deeper. */
+
+	if (counts[chars[0]] == n) {
+	    if (chars[0] == '\0')
+		return;
+
+	    depth ++;
+	    continue;
+	}
+
+	for (sum = 0, c = 0; c < 256; c ++) {
+	    places[c] = sum;
+	    sum += counts[c];
+	}
+
+	for (i = 0; i < n; i ++)
+	    temp[places[chars[i]] ++] = strs[i];
+
+	memcpy(strs, temp, sizeof(char *) * n);
+
+	for (sum = counts[0], c = 1; c < 256; sum += counts[c ++])
+	    if (counts[c] > 1)
+		radixSort(strs + sum, counts[c], depth + 1, temp, chars);
+
+	return;
+    }
+
+    multikeySort(strs, n, depth);
+}
+
+
+/*
+ * Function:	sortSerial
+ *
+ * Complexity:	O(n logn) average case, O(n^2) worst case
+ *
+ * Description:	Sort the N elements of ELTS in place using COMPARE on the
+ *		calling thread.  If COMPARE is strcmp, the elements are
+ *		strings and are sorted by their characters.
+ */
+
+static void sortSerial(void **elts, int n, int (*compare)())
+{
+    char **temp;
+    unsigned char *chars;
+
+
+    if (compare != (int (*)()) strcmp)
+	quickSort(elts, compare, n);
+
+    else if (n <= RADIX_CUTOFF)
+	multikeySort((char **) elts, n, 0);
+
+    else {
+	temp = malloc(sizeof(char *) * n);
+	chars = malloc(n);
+	assert(temp != NULL && chars != NULL);
+	radixSort((char **) elts, n, 0, temp, chars);
+	free(temp);
+	free(chars);
+    }
+}
+
+
+# ifdef PARALLEL_SORT
+
+/*
+ * Function:	split
+ *
+ * Complexity:	O(log n)
+ *
+ * Description:	Return how many of the first I elements of the stable
+ *		merge of the M elements of A and the N elements of B come
+ *		from A.  An element of A that is equal to one of B comes
+ *		first.
+ */
+
+static int split(int i, void **a, int m, void **b, int n, int (*compare)())
+{
+    int lo, hi, j;
+
+
+    lo = i > n ? i - n : 0;
+    hi = i < m ? i : m;
+
+    while (lo < hi) {
+	j = (lo + hi) / 2;
+
+	if (compare(a[j], b[i - j - 1]) <= 0)
+	    lo = j + 1;
+	else
+	    hi = j;
+    }
+
+    return lo;
+}
+
+
+/*
+ * Function:	mergeRange
+ *
+ * Complexity:	O(n + log n)
+ *
+ * Description:	Merge the sorted elements SRC[LO..MID) and SRC[MID..HI)
+ *		into DST[LO..HI), but only write DST[FIRST..LAST).
+ */
+
+static void mergeRange(void **src, void **dst, int lo, int mid, int hi,
+    int first, int last, int (*compare)())
+{
+    int i, j, k;
+
+
+    j = split(first - lo, src + lo, mid - lo, src + mid, hi - mid, compare);
+    i = lo + j;
+    j = mid + (first - lo - j);
+
+    for (k = first; k < last; k ++)
+	if (j == hi || (i < mid && compare(src[i], src[j]) <= 0))
+	    dst[k] = src[i ++];
+	else
+	    dst[k] = src[j ++];
+}
+
+
+/*
+ * Function:	sortSlice
+ *
+ * Complexity:	O(n/t logn) average case, for t threads
+ *
+ * Description:	Sort the slice of the worker pointed to by ARG and then
+ *		help merge the slices.  This is the function that each
+ *		thread runs.  In each round, slices are merged in pairs and
+ *		each thread writes its own part of the output, which is the
+ *		same part of the array in every round.  The threads wait
+ *		for each other after each round, since the next round reads
+ *		what every thread wrote, and once more at the end, so the
+ *		array is done when any thread returns.
+ */
+
+static void *sortSlice(void *arg)
+{
+    struct worker *wp = arg;
+    struct pool *pp = wp->pp;
+    int first, last, width, n, t, lo, mid, hi;
+    void **src, **dst, **x;
+
+
+    n = pp->threads;
+    lo = pp->slices[wp->id];
+    hi = pp->slices[wp->id + 1];
+    sortSerial(pp->elts + lo, hi - lo, pp->compare);
+    pthread_barrier_wait(&pp->barrier);
+
+    first = pp->slices[wp->id];
+    last = pp->slices[wp->id + 1];
+    src = pp->elts;
+    dst = pp->temp;
+
+    for (width = 1; width < n; width *= 2) {
+	for (t = 0; t < n; t += 2 * width) {
+	    lo = pp->slices[t];
+	    mid = pp->slices[t + width < n ? t + width : n];
+	    hi = pp->slices[t + 2 * width < n ? t + 2 * width : n];
+
+	    if (lo < last && first < hi)
+		mergeRange(src, dst, lo, mid, hi, first > lo ? first : lo,
+		    last < hi ? last : hi, pp->compare);
+	}
+
+	pthread_barrier_wait(&pp->barrier);
+
+	x = src;
+	src = dst;
+	dst = x;
+    }
+
+    if (src != pp->elts)
+	memcpy(pp->elts + first, src + first, sizeof(void *) * (last - first));
+
+    pthread_barrier_wait(&pp->barrier);
+    return NULL;
+}
+
+
+/*
+ * Function:	runWorker
+ *
+ * Complexity:	O(1) per job, besides the sorting
+ *
+ * Description:	Wait for a job to be started and then sort the slice of
+ *		the worker pointed to by ARG, over and over.  This is the
+ *		function that each thread of the pool runs.
+ */
+
+static void *runWorker(void *arg)
+{
+    int job;
+
+
+    job = 0;
+
+    while (true) {
+	pthread_mutex_lock(&pool.lock);
+
+	while (pool.job == job)
+	    pthread_cond_wait(&pool.start, &pool.lock);
+
+	job = pool.job;
+	pthread_mutex_unlock(&pool.lock);
+	sortSlice(arg);
+    }
+
+    return NULL;
+}
+
+
+/*
+ * Function:	poolSize
+ *
+ * Complexity:	O(1)
+ *
+ * Description:	Return the number of threads to sort with, which is the
+ *		number of processors, or SORT_THREADS from the environment
+ *		if it is set.  There are never more threads than elements
+ *		in the smallest array sorted in parallel, since the rest
+ *		would only have empty slices.
+ */
+
+static int poolSize(void)
+{
+    char *s;
+    long t;
+
+
+    s = getenv("SORT_THREADS");
+    t = s != NULL ? atol(s) : sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (t < 1)
+	return 1;
+
+    return t < PARALLEL_CUTOFF ? t : PARALLEL_CUTOFF;
+}
+
+
+/*
+ * Function:	startPool
+ *
+ * Complexity:	O(t), for t threads
+ *
+ * Description:	Set up the pool and start all of its threads but the
+ *		first, which is whichever thread calls parallelSort.  If
+ *		a thread cannot be started, the pool is just the threads
+ *		started before it.  This is only done once, and the
+ *		threads are never stopped.
+ */
+
+static void startPool(void)
+{
+    pthread_attr_t attr;
+    pthread_t id;
+    int t, n;
+
+
+    n = poolSize();
+    workers = malloc(sizeof(struct worker) * n);
+    pool.slices = malloc(sizeof(int) * (n + 1));
+    assert(workers != NULL && pool.slices != NULL);
+
+    pool.job = 0;
+    pool.running = false;
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.start, NULL);
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+    for (t = 0; t < n; t ++) {
+	workers[t].pp = &pool;
+	workers[t].id = t;
+
+	if (t > 0 && pthread_create(&id, &attr, runWorker, &workers[t]) != 0)
+	    break;
+    }
+
+    pthread_attr_destroy(&attr);
+    pool.threads = t;
+    pthread_barrier_init(&pool.barrier, NULL, pool.threads);
+}
+
+
+/*
+ * Function:	parallelSort
+ *
+ * Complexity:	O(n/t logn + n/t log t) average case, for t threads
+ *
+ * Description:	Sort the N elements of ELTS in place using COMPARE on the
+ *		threads of the pool and return true, or return false if
+ *		the pool is already busy with another array.  The first
+ *		slice is sorted on the calling thread.
+ */
+
+static bool parallelSort(void **elts, int n, int (*compare)())
+{
+    void **temp;
+    int t;
+
+
+    temp = malloc(sizeof(void *) * n);
+    assert(temp != NULL);
+    pthread_mutex_lock(&pool.lock);
+
+    if (pool.running) {
+	pthread_mutex_unlock(&pool.lock);
+	free(temp);
+	return false;
+    }
+
+    pool.running = true;
+    pool.elts = elts;
+    pool.temp = temp;
+    pool.n = n;
+    pool.compare = compare;
+
+    for (t = 0; t <= pool.threads; t ++)
+	pool.slices[t] = (long) n * t / pool.threads;
+
+    pool.job ++;
+    pthread_cond_broadcast(&pool.start);
+    pthread_mutex_unlock(&pool.lock);
+
+    sortSlice(&workers[0]);
+
+    pthread_mutex_lock(&pool.lock);
+    pool.running = false;
+    pthread_mutex_unlock(&pool.lock);
+    free(temp);
+    return true;
+}
+
+# endif
+
+
+/*
+ * Function:	sortElements
+ *
+ * Complexity:	O(n logn) average case, O(n^2) worst case
+ *
+ * Description:	Sort the N elements of ELTS in place using COMPARE.  If
+ *		COMPARE is strcmp, the elements are strings and are sorted
+ *		by their characters.
+ */
+
+void sortElements(void **elts, int n, int (*compare)())
+{
+# ifdef PARALLEL_SORT
+    if (n >= PARALLEL_CUTOFF) {
+	pthread_once(&started, startPool);
+
+	if (pool.threads > 1 && parallelSort(elts, n, compare))
+	    return;
+    }
+# endif
+
+    sortSerial(elts, n, compare);
+}
@@ -0,0 +1,15 @@
+/*
+ * File:        sort.h
+ *
+ * Copyright:	2024, theonelog
+ *
+ * Description: This file contains the public function declarations for
+ *              sorting the arrays of elements returned by getElements.
+ */
+
+# ifndef SORT_H
+# define SORT_H
+
+void sortElements(void **elts, int n, int (*compare)());
+
+# endif /* SORT_H */
@@ -0,0 +1,598 @@
+/*
+ * File:        swiss.c
+ *
+ * Copyright:	2024, theonelog
+ *
+ * Description: This file contains the public and private function and type
+ *              definitions for a set abstract data type for generic
+ *              pointer types.  A set is an unordered collection of unique
+ *              elements.
+ *
+ *              This implementation is an alternative to table.c using a
+ *              "Swiss table" layout.  Alongside the array of elements is
+ *              an array of control bytes, one per slot.  A control byte
+ *              is EMPTY, DELETED, or holds the low seven bits of the
+ *              element's hash.  Slots are probed a group of GROUP at a
+ *              time: the control bytes of a group are compared against
+ *              the hash fragment in one SSE2 instruction, and the
+ *              comparison function is only called on slots whose
+ *              fragment matches.  The full hash of each element is kept
+ *              as well, so that growing the table never calls the hash
+ *              function again.
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <assert.h>
+# include <stdbool.h>
+# include "set.h"
+# include "sort.h"
+
+# ifdef __SSE2__
+# include <emmintrin.h>
+# endif
+
+# define EMPTY   ((signed char) 0x80)
+# define DELETED ((signed char) 0xfe)
+
+# define GROUP      16		/* slots examined at once           */
+# define MIN_GROUPS 1		/* smallest table ever allocated    */
+# define MAX_LOAD(n) ((n) / 8 * 7)	/* most used slots in a table       */
+
+# ifdef SETSTATS
+# define STAT(x) (x)
+# else
+# define STAT(x)
+# endif
+
+struct set {
+    int count;                  /* number of elements in set   */
+    int used;                   /* number of non-empty slots   */
+    int groups;                 /* number of groups of slots   */
+    int maxProbe;               /* most groups probed to insert */
+    void **data;                /* array of allocated elements */
+    unsigned *hashes;           /* mixed hash of each element  */
+    signed char *ctrl;          /* control byte of each slot   */
+    int (*compare)();		/* comparison function         */
+    unsigned (*hash)();		/* hash function               */
+# ifdef SETSTATS
+    struct setstats stats;	/* instrumentation counters    */
+# endif
+};
+
+
+/*
+ * Function:    mix
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Scramble the hash value H so that all of its bits depend
+ *		on all of the bits of the user's hash value.  The low seven
+ *		bits are kept in the control byte and the rest choose the
+ *		first group to probe.
+ */
+
+static unsigned mix(unsigned h)
+{
+    h ^= h >> 16;
+    h *= 0x45d9f3b;
+    h ^= h >> 16;
+
+    return h;
+}
+
+
+/*
+ * Function:    hashElement
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return the mixed hash value of ELT for the set pointed to
+ *		by SP.
+ */
+
+static unsigned hashElement(SET *sp, void *elt)
+{
+    STAT(sp->stats.hashes ++);
+    return mix((*sp->hash)(elt));
+}
+
+
+# ifdef SETSTATS
+/*
+ * Function:    record
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Count a search of the set pointed to by SP that examined
+ *		PROBES groups.
+ */
+
+static void record(SET *sp, int probes)
+{
+    sp->stats.searches ++;
+    sp->stats.probes[probes < SETSTATS_BUCKETS ? probes : SETSTATS_BUCKETS - 1] ++;
+
+    if (probes > sp->stats.maxProbe)
+	sp->stats.maxProbe = probes;
+}
+# endif
+
+
+/*
+ * Function:    match
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return a bit mask of the slots in the group starting at
+ *		CTRL whose control byte equals BYTE.
+ */
+
+static unsigned match(signed char *ctrl, signed char byte)
+{
+# ifdef __SSE2__
+    __m128i group = _mm_loadu_si128((__m128i *) ctrl);
+
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(byte)));
+# else
+    unsigned i, mask = 0;
+
+    for (i = 0; i < GROUP; i ++)
+	if (ctrl[i] == byte)
+	    mask |= 1u << i;
+
+    return mask;
+# endif
+}
+
+
+/*
+ * Function:    available
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return a bit mask of the slots in the group starting at
+ *		CTRL that are either empty or deleted.  Only those control
+ *		bytes have their high bit set.
+ */
+
+static unsigned available(signed char *ctrl)
+{
+# ifdef __SSE2__
+    return _mm_movemask_epi8(_mm_loadu_si128((__m128i *) ctrl));
+# else
+    unsigned i, mask = 0;
+
+    for (i = 0; i < GROUP; i ++)
+	if (ctrl[i] < 0)
+	    mask |= 1u << i;
+
+    return mask;
+# endif
+}
+
+
+/*
+ * Function:    first
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return the index of the lowest bit set in MASK.
+ */
+
+static int first(unsigned mask)
+{
+    return __builtin_ctz(mask);
+}
+
+
+/*
+ * Function:    allocate
+ *
+ * Complexity:  O(m)
+ *
+ * Description: Allocate the arrays for the set pointed to by SP with
+ *		GROUPS groups of empty slots.
+ */
+
+static void allocate(SET *sp, int groups)
+{
+    sp->data = malloc(sizeof(void *) * groups * GROUP);
+    assert(sp->data != NULL);
+    sp->hashes = malloc(sizeof(unsigned) * groups * GROUP);
+    assert(sp->hashes != NULL);
+
+    sp->ctrl = malloc(sizeof(signed char) * groups * GROUP);
+    assert(sp->ctrl != NULL);
+
+    memset(sp->ctrl, EMPTY, groups * GROUP);
+    sp->groups = groups;
+    sp->used = 0;
+    sp->maxProbe = 0;
+}
+
+
+/*
+ * Function:    search
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Return the location of ELT, whose mixed hash value is H,
+ *		in the set pointed to by SP.  If the element is present,
+ *		then *FOUND is true.  If not present, then *FOUND is false
+ *		and the location is where it should be inserted, with
+ *		*PROBES set to the number of groups probed to reach it.  The
+ *		groups are probed quadratically, and the search stops at
+ *		the first group that has an empty slot.
+ */
+
+static int search(SET *sp, void *elt, unsigned h, int *probes, bool *found)
+{
+    int i, g, locn, slot;
+    unsigned mask;
+    signed char *ctrl;
+
+
+    slot = -1;
+    g = (h >> 7) & (sp->groups - 1);
+
+    for (i = 1; i <= sp->groups; i ++) {
+	ctrl = sp->ctrl + g * GROUP;
+
+	for (mask = match(ctrl, h & 0x7f); mask != 0; mask &= mask - 1) {
+	    locn = g * GROUP + first(mask);
+	    STAT(sp->stats.compares ++);
+
+	    if ((*sp->compare)(sp->data[locn], elt) == 0) {
+		STAT(record(sp, i));
+		*found = true;
+		return locn;
+	    }
+	}
+
+	if (slot == -1 && (mask = available(ctrl)) != 0) {
+	    slot = g * GROUP + first(mask);
+	    *probes = i;
+	}
+
+	if (match(ctrl, EMPTY) != 0)
+	    break;
+
+	g = (g + i) & (sp->groups - 1);
+    }
+
+    STAT(record(sp, i <= sp->groups ? i : sp->groups));
+    *found = false;
+    return slot;
+}
+
+
+/*
+ * Function:    place
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Return the location where an element whose mixed hash
+ *		value is H should be inserted into the set pointed to by SP,
+ *		when the element is known not to be present, and set
+ *		*PROBES to the number of groups probed to reach it.  This is
+ *		the slot search would return, but no elements are compared
+ *		and nothing is counted as a search.
+ */
+
+static int place(SET *sp, unsigned h, int *probes)
+{
+    int i, g;
+    unsigned mask;
+
+
+    g = (h >> 7) & (sp->groups - 1);
+
+    for (i = 1; (mask = available(sp->ctrl + g * GROUP)) == 0; i ++)
+	g = (g + i) & (sp->groups - 1);
+
+    *probes = i;
+    return g * GROUP + first(mask);
+}
+
+
+/*
+ * Function:    insert
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Store ELT, whose mixed hash value is H, at location LOCN in
+ *		the set pointed to by SP, which took PROBES groups to find.
+ */
+
+static void insert(SET *sp, int locn, void *elt, unsigned h, int probes)
+{
+    if (sp->ctrl[locn] == EMPTY)
+	sp->used ++;
+
+    if (probes > sp->maxProbe)
+	sp->maxProbe = probes;
+
+    sp->data[locn] = elt;
+    sp->hashes[locn] = h;
+    sp->ctrl[locn] = h & 0x7f;
+}
+
+
+/*
+ * Function:    rehash
+ *
+ * Complexity:  O(m)
+ *
+ * Description: Move the elements of the set pointed to by SP into a new
+ *		table.  The table doubles in size if at least half of its
+ *		slots hold elements, otherwise it is rebuilt at the same
+ *		size to drop the deleted slots.  Each element is placed by
+ *		its saved hash, so neither the hash function nor the
+ *		comparison function is called.
+ */
+
+static void rehash(SET *sp)
+{
+    int i, groups, locn, probes;
+    void **data;
+    unsigned *hashes;
+    signed char *ctrl;
+
+
+    data = sp->data;
+    hashes = sp->hashes;
+    ctrl = sp->ctrl;
+    groups = sp->groups;
+
+    allocate(sp, sp->count >= groups * GROUP / 2 ? groups * 2 : groups);
+    STAT(sp->stats.resizes ++);
+
+    for (i = 0; i < groups * GROUP; i ++)
+	if (ctrl[i] >= 0) {
+	    locn = place(sp, hashes[i], &probes);
+	    insert(sp, locn, data[i], hashes[i], probes);
+	}
+
+    free(ctrl);
+    free(hashes);
+    free(data);
+}
+
+
+/*
+ * Function:    createSet
+ *
+ * Complexity:  O(m)
+ *
+ * Description: Return a pointer to a new set sized to hold MAXELTS
+ *		elements before it first needs to grow.
+ */
+
+SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)())
+{
+    int groups;
+    SET *sp;
+
+
+    assert(compare != NULL && hash != NULL);
+
+    sp = malloc(sizeof(SET));
+    assert(sp != NULL);
+
+    groups = MIN_GROUPS;
+
+    while (MAX_LOAD(groups * GROUP) < maxElts)
+	groups *= 2;
+
+    allocate(sp, groups);
+    sp->compare = compare;
+    sp->hash = hash;
+    sp->count = 0;
+
+    STAT(memset(&sp->stats, 0, sizeof(sp->stats)));
+    return sp;
+}
+
+
+/*
+ * Function:    destroySet
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Deallocate memory associated with the set pointed to by SP.
+ *		The elements themselves are not deallocated since we did not
+ *		allocate them in the first place.
+ */
+
+void destroySet(SET *sp)
+{
+    assert(sp != NULL);
+
+    free(sp->ctrl);
+    free(sp->hashes);
+    free(sp->data);
+    free(sp);
+}
+
+
+/*
+ * Function:    numElements
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return the number of elements in the set pointed to by SP.
+ */
+
+int numElements(SET *sp)
+{
+    assert(sp != NULL);
+    return sp->count;
+}
+
+
+/*
+ * Function:    addElement
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Add ELT to the set pointed to by SP.  The table is rehashed
+ *		first if the insertion would overload it.
+ */
+
+void addElement(SET *sp, void *elt)
+{
+    int locn, probes;
+    unsigned h;
+    bool found;
+
+
+    assert(sp != NULL && elt != NULL);
+
+    h = hashElement(sp, elt);
+    locn = search(sp, elt, h, &probes, &found);
+
+    if (!found) {
+	if (sp->ctrl[locn] == EMPTY && sp->used >= MAX_LOAD(sp->groups * GROUP)) {
+	    rehash(sp);
+	    locn = search(sp, elt, h, &probes, &found);
+	}
+
+	insert(sp, locn, elt, h, probes);
+	sp->count ++;
+    }
+}
+
+
+/*
+ * Function:    removeElement
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Remove ELT from the set pointed to by SP.  If the slot's
+ *		group still has an empty slot then no search has ever probed
+ *		past it, so the slot can be made empty again.  Otherwise it
+ *		is marked as deleted.
+ */
+
+void removeElement(SET *sp, void *elt)
+{
+    int locn, probes;
+    bool found;
+
+
+    assert(sp != NULL && elt != NULL);
+
+    locn = search(sp, elt, hashElement(sp, elt), &probes, &found);
+
+    if (found) {
+	if (match(sp->ctrl + locn / GROUP * GROUP, EMPTY) != 0) {
+	    sp->ctrl[locn] = EMPTY;
+	    sp->used --;
+	} else
+	    sp->ctrl[locn] = DELETED;
+
+	sp->count --;
+    }
+}
+
+
+/*
+ * Function:    findElement
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: If ELT is present in the set pointed to by SP then return
+ *		it, otherwise return NULL.
+ */
+
+void *findElement(SET *sp, void *elt)
+{
+    int locn, probes;
+    bool found;
+
+
+    assert(sp != NULL && elt != NULL);
+
+    locn = search(sp, elt, hashElement(sp, elt), &probes, &found);
+    return found ? sp->data[locn] : NULL;
+}
+
+
+/*
+ * Function:	getElements
+ *
+ * Complexity:	O(n logn)
+ *
+ * Description:	Allocate and return a sorted array of elements in the set
+ *		pointed to by SP.
+ */
+
+void *getElements(SET *sp)
+{
+    int i, j;
+    void **elts;
+
+
+    assert(sp != NULL);
+
+    elts = malloc(sizeof(void *) * sp->count);
+    assert(elts != NULL);
+
+    for (i = 0, j = 0; i < sp->groups * GROUP; i ++)
+	if (sp->ctrl[i] >= 0)
+	    elts[j ++] = sp->data[i];
+
+    sortElements(elts, sp->count, sp->compare);
+    return elts;
+}
+
+
+/*
+ * Function:	maxProbeLength
+ *
+ * Complexity:	O(1)
+ *
+ * Description:	Return the largest number of groups, each of GROUP slots,
+ *		that any insertion into the set pointed to by SP has had to
+ *		probe since the table was last rehashed.
+ */
+
+int maxProbeLength(SET *sp)
+{
+    assert(sp != NULL);
+    return sp->maxProbe;
+}
+
+
+# ifdef SETSTATS
+/*
+ * Function:	getSetStats
+ *
+ * Complexity:	O(m)
+ *
+ * Description:	Fill in OUT with the instrumentation counters of the set
+ *		pointed to by SP.  The deleted slots and the bytes held by
+ *		the table are counted as of now.  Probe lengths are counted
+ *		in groups of GROUP slots.
+ */
+
+void getSetStats(SET *sp, struct setstats *out)
+{
+    int i;
+
+
+    assert(sp != NULL && out != NULL);
+
+    *out = sp->stats;
+    out->tombstones = 0;
+
+    for (i = 0; i < sp->groups * GROUP; i ++)
+	if (sp->ctrl[i] == DELETED)
+	    out->tombstones ++;
+
+    out->bytes = sizeof(SET) + (long) sp->groups * GROUP *
+	(sizeof(void *) + sizeof(unsigned) + sizeof(signed char));
+}
+# endif
@@ -9,9 +9,28 @@
  *              elements.
  *
  *              This implementation uses a hash table to store the
- *              elements, with linear probing to resolve collisions.
- *              Insertion, deletion, and membership checks are all average
- *              case constant time.
+ *              elements, with Robin Hood linear probing to resolve
+ *              collisions.  Insertion, deletion, and membership checks are
+ *              all average case constant time.  An element being inserted
+ *              takes the slot of any element that is closer to its home
+ *              slot, which keeps the longest probe sequence short, and a
+ *              deletion shifts the following elements back rather than
+ *              leaving a deleted slot behind.
+ *
+ *              The table grows as elements are added.  Once the load
+ *              factor passes MAX_LOAD, or a probe sequence grows longer
+ *              than MAX_PROBE, a table twice as long is allocated and the
+ *              old table is migrated into it a few slots at a time on each
+ *              later insertion or deletion, so no single operation pays
+ *              for copying the whole table.  Elements deleted from the old
+ *              table while it is being migrated are only marked as
+ *              deleted, and are dropped during the migration.
+ *
+ *              The hash value of each element is kept next to its slot.
+ *              A search only calls the comparison function on slots
+ *              whose hash value matches, the probe distance of a slot is
+ *              computed from its hash value, and the migration never
+ *              calls the hash function again.
  */
 
 # include <stdio.h>
@@ -19,62 +38,445 @@
 # include <string.h>
 # include <assert.h>
 # include <stdbool.h>
-#include <time.h>
 # include "set.h"
+# include "sort.h"
 
 # define EMPTY   0
 # define FILLED  1
 # define DELETED 2
 
-struct set {
-    int count;                  /* number of elements in array */
-    int length;                 /* length of allocated array   */
+# define MIN_LENGTH 16		/* smallest table ever allocated    */
+# define MAX_LOAD(n) ((n) / 4 * 3)	/* most used slots in a table       */
+# define MAX_PROBE  32		/* longest probe sequence allowed   */
+# define MIGRATE    8		/* old slots moved per update       */
+
+# ifdef SETSTATS
+# define STAT(x) (x)
+# else
+# define STAT(x)
+# endif
+
+struct table {
+    int length;                 /* length of allocated arrays  */
+    int used;                   /* number of non-empty slots   */
+    int maxProbe;               /* longest probe sequence      */
     void **data;                /* array of allocated elements */
+    unsigned *hashes;           /* hash value of each element  */
     char *flags;                /* state of each slot in array */
+};
+
+struct set {
+    int count;                  /* number of elements in set   */
+    int next;                   /* next old slot to migrate    */
+    struct table cur;           /* table receiving insertions  */
+    struct table old;           /* table being migrated, if any */
     int (*compare)();		/* comparison function         */
     unsigned (*hash)();		/* hash function               */
+# ifdef SETSTATS
+    struct setstats stats;	/* instrumentation counters    */
+# endif
 };
 
 
+/*
+ * Function:    mix
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Scramble the hash value H so that its low bits depend on
+ *		all of its bits.  The table lengths are powers of two, so
+ *		only the low bits are used to choose a slot.
+ */
+
+static unsigned mix(unsigned h)
+{
+    h ^= h >> 16;
+    h *= 0x45d9f3b;
+    h ^= h >> 16;
+
+    return h;
+}
+
+
+/*
+ * Function:    hashElement
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return the mixed hash value of ELT for the set pointed to
+ *		by SP.
+ */
+
+static unsigned hashElement(SET *sp, void *elt)
+{
+    STAT(sp->stats.hashes ++);
+    return mix((*sp->hash)(elt));
+}
+
+
+# ifdef SETSTATS
+/*
+ * Function:    record
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Count a search of the set pointed to by SP that examined
+ *		PROBES slots.
+ */
+
+static void record(SET *sp, int probes)
+{
+    sp->stats.searches ++;
+    sp->stats.probes[probes < SETSTATS_BUCKETS ? probes : SETSTATS_BUCKETS - 1] ++;
+
+    if (probes > sp->stats.maxProbe)
+	sp->stats.maxProbe = probes;
+}
+# endif
+
+
+/*
+ * Function:    allocate
+ *
+ * Complexity:  O(m)
+ *
+ * Description: Allocate the arrays for the table pointed to by TP with
+ *		LENGTH empty slots.
+ */
+
+static void allocate(struct table *tp, int length)
+{
+    int i;
+
+
+    tp->data = malloc(sizeof(void *) * length);
+    assert(tp->data != NULL);
+
+    tp->hashes = malloc(sizeof(unsigned) * length);
+    assert(tp->hashes != NULL);
+
+    tp->flags = malloc(sizeof(char) * length);
+    assert(tp->flags != NULL);
+
+    tp->length = length;
+    tp->used = 0;
+    tp->maxProbe = 0;
+
+    for (i = 0; i < length; i ++)
+        tp->flags[i] = EMPTY;
+}
+
+
+/*
+ * Function:    release
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Deallocate the arrays for the table pointed to by TP.
+ */
+
+static void release(struct table *tp)
+{
+    free(tp->flags);
+    free(tp->hashes);
+    free(tp->data);
+
+    tp->data = NULL;
+    tp->hashes = NULL;
+    tp->flags = NULL;
+    tp->length = 0;
+    tp->used = 0;
+    tp->maxProbe = 0;
+}
+
+
+/*
+ * Function:    distance
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return the probe distance of the element in slot LOCN of
+ *		the table pointed to by TP, which is how far it sits past
+ *		the slot its hash value maps to.
+ */
+
+static int distance(struct table *tp, int locn)
+{
+    return (locn - tp->hashes[locn]) & (tp->length - 1);
+}
+
+
 /*
  * Function:    search
  *
  * Complexity:  O(1) average case, O(n) worst case
  *
- * Description: Return the location of ELT in the set pointed to by SP.  If
- *		the element is present, then *FOUND is true.  If not
- *		present, then *FOUND is false.  The element is first hashed
- *		to its correct location.  Linear probing is used to examine
- *		subsequent locations.
+ * Description: Return the location of ELT, whose hash value is H, in the
+ *		table pointed to by TP.  If the element is present, then
+ *		*FOUND is true.  If not present, then *FOUND is false.  The
+ *		element is first hashed to its correct location.  Linear
+ *		probing is used to examine subsequent locations.  The
+ *		search stops at an empty slot or at a slot whose element is
+ *		closer to home than ELT would be, since an insertion of ELT
+ *		would have taken that slot.  That slot is returned, with
+ *		*DIST set to the probe distance ELT would have there.
  */
 
-static int search(SET *sp, void *elt, bool *found)
+static int search(SET *sp, struct table *tp, void *elt, unsigned h,
+	int *dist, bool *found)
 {
-    int available, i, locn, start;
-
+    int locn, mask;
 
-    available = -1;
-    start = (*sp->hash)(elt) % sp->length;
 
-    for (i = 0; i < sp->length; i ++) {
-        locn = (start + i) % sp->length;
+    mask = tp->length - 1;
+    locn = h & mask;
 
-        if (sp->flags[locn] == EMPTY) {
+    for (*dist = 0; *dist < tp->length; (*dist) ++) {
+        if (tp->flags[locn] == EMPTY || distance(tp, locn) < *dist) {
+	    STAT(record(sp, *dist + 1));
             *found = false;
-            return available != -1 ? available : locn;
+            return locn;
 
-        } else if (sp->flags[locn] == DELETED) {
-            if (available == -1)
-		available = locn;
+        } else if (tp->flags[locn] == FILLED && tp->hashes[locn] == h) {
+	    STAT(sp->stats.compares ++);
 
-        } else if ((*sp->compare)(sp->data[locn], elt) == 0) {
-            *found = true;
-            return locn;
+	    if ((*sp->compare)(tp->data[locn], elt) == 0) {
+		STAT(record(sp, *dist + 1));
+		*found = true;
+		return locn;
+	    }
         }
+
+	locn = (locn + 1) & mask;
     }
 
+    STAT(record(sp, tp->length));
     *found = false;
-    return available;
+    return -1;
+}
+
+
+/*
+ * Function:    place
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Return the slot in the table pointed to by TP where an
+ *		element with hash value H that is known not to be present
+ *		should be inserted, and set *DIST to its probe distance
+ *		there.  This is the same slot search would return, but no
+ *		elements are compared and nothing is counted as a search.
+ */
+
+static int place(struct table *tp, unsigned h, int *dist)
+{
+    int locn, mask;
+
+
+    mask = tp->length - 1;
+    locn = h & mask;
+    *dist = 0;
+
+    while (tp->flags[locn] != EMPTY && distance(tp, locn) >= *dist) {
+	locn = (locn + 1) & mask;
+	(*dist) ++;
+    }
+
+    return locn;
+}
+
+
+/*
+ * Function:    insert
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Store ELT, whose hash value is H, at location LOCN in the
+ *		table pointed to by TP, where its probe distance is DIST.
+ *		Whenever the slot is taken by an element that is closer to
+ *		home, the two are swapped and the displaced element moves
+ *		on to find its own slot.
+ */
+
+static void insert(struct table *tp, int locn, void *elt, unsigned h,
+	int dist)
+{
+    void *data;
+    unsigned hash;
+    int mask, temp;
+
+
+    mask = tp->length - 1;
+
+    while (tp->flags[locn] != EMPTY) {
+	if ((temp = distance(tp, locn)) < dist) {
+	    data = tp->data[locn];
+	    hash = tp->hashes[locn];
+
+	    tp->data[locn] = elt;
+	    tp->hashes[locn] = h;
+
+	    if (dist >= tp->maxProbe)
+		tp->maxProbe = dist + 1;
+
+	    elt = data;
+	    h = hash;
+	    dist = temp;
+	}
+
+	locn = (locn + 1) & mask;
+	dist ++;
+    }
+
+    tp->data[locn] = elt;
+    tp->hashes[locn] = h;
+    tp->flags[locn] = FILLED;
+    tp->used ++;
+
+    if (dist >= tp->maxProbe)
+	tp->maxProbe = dist + 1;
+}
+
+
+/*
+ * Function:    delete
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Empty slot LOCN of the table pointed to by TP.  Each of the
+ *		following elements that is not in its home slot is shifted
+ *		back one slot, so that no deleted slot is left behind.
+ */
+
+static void delete(struct table *tp, int locn)
+{
+    int next, mask;
+
+
+    mask = tp->length - 1;
+    next = (locn + 1) & mask;
+
+    while (tp->flags[next] == FILLED && distance(tp, next) > 0) {
+	tp->data[locn] = tp->data[next];
+	tp->hashes[locn] = tp->hashes[next];
+
+	locn = next;
+	next = (locn + 1) & mask;
+    }
+
+    tp->flags[locn] = EMPTY;
+    tp->used --;
+}
+
+
+/*
+ * Function:    locate
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Return the location of ELT, whose hash value is H, in the
+ *		set pointed to by SP and set *TP to the table holding it.
+ *		If the element is not present, then the location is the
+ *		slot in the current table where it should be inserted, and
+ *		*DIST is its probe distance there.
+ */
+
+static int locate(SET *sp, void *elt, unsigned h, struct table **tp,
+	int *dist, bool *found)
+{
+    int locn;
+
+
+    if (sp->old.data != NULL) {
+	locn = search(sp, &sp->old, elt, h, dist, found);
+
+	if (*found) {
+	    *tp = &sp->old;
+	    return locn;
+	}
+    }
+
+    *tp = &sp->cur;
+    return search(sp, &sp->cur, elt, h, dist, found);
+}
+
+
+/*
+ * Function:    migrate
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Move up to STEPS slots from the old table of the set
+ *		pointed to by SP into its current table.  Deleted slots are
+ *		simply skipped.  A moved slot is marked as deleted so that
+ *		probing in the old table still works but never finds it.
+ *		The old table is released once it is empty.  Since a moved
+ *		element cannot already be in the current table, its slot is
+ *		found with place, and the moves do not count as searches.
+ */
+
+static void migrate(SET *sp, int steps)
+{
+    int locn, dist;
+    unsigned h;
+
+
+    while (sp->old.data != NULL && steps -- > 0) {
+	if (sp->old.flags[sp->next] == FILLED) {
+	    h = sp->old.hashes[sp->next];
+	    locn = place(&sp->cur, h, &dist);
+	    insert(&sp->cur, locn, sp->old.data[sp->next], h, dist);
+	    sp->old.flags[sp->next] = DELETED;
+	}
+
+	if (++ sp->next == sp->old.length)
+	    release(&sp->old);
+    }
+}
+
+
+/*
+ * Function:    expand
+ *
+ * Complexity:  O(m)
+ *
+ * Description: Replace the current table of the set pointed to by SP with
+ *		one twice as long and start migrating the elements into it.
+ *		Any migration still in progress is finished first.
+ */
+
+static void expand(SET *sp)
+{
+    migrate(sp, sp->old.length);
+    STAT(sp->stats.resizes ++);
+
+    sp->old = sp->cur;
+    sp->next = 0;
+    allocate(&sp->cur, sp->old.length * 2);
+}
+
+
+/*
+ * Function:    overloaded
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return whether the current table of the set pointed to by
+ *		SP is too full to take another element.  A probe sequence
+ *		longer than MAX_PROBE only counts once the table is a
+ *		quarter full, so that a poor hash function cannot make the
+ *		table grow without bound.
+ */
+
+static bool overloaded(SET *sp)
+{
+    struct table *tp = &sp->cur;
+
+
+    if (tp->used >= MAX_LOAD(tp->length))
+	return true;
+
+    return tp->maxProbe > MAX_PROBE && tp->used >= tp->length / 4;
 }
 
 
@@ -83,13 +485,13 @@ static int search(SET *sp, void *elt, bool *found)
  *
  * Complexity:  O(m)
  *
- * Description: Return a pointer to a new set with a maximum capacity of
- *		MAXELTS.
+ * Description: Return a pointer to a new set sized to hold MAXELTS
+ *		elements before it first needs to grow.
  */
 
 SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)())
 {
-    int i;
+    int length;
     SET *sp;
 
 
@@ -98,20 +500,25 @@ SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)())
     sp = malloc(sizeof(SET));
     assert(sp != NULL);
 
-    sp->data = malloc(sizeof(char *) * maxElts);
-    assert(sp->data != NULL);
+    length = MIN_LENGTH;
+
+    while (MAX_LOAD(length) < maxElts)
+	length *= 2;
 
-    sp->flags = malloc(sizeof(char) * maxElts);
-    assert(sp->flags != NULL);
+    allocate(&sp->cur, length);
+    sp->old.data = NULL;
+    sp->old.hashes = NULL;
+    sp->old.flags = NULL;
+    sp->old.length = 0;
+    sp->old.used = 0;
+    sp->old.maxProbe = 0;
+    sp->next = 0;
 
     sp->compare = compare;
     sp->hash = hash;
-    sp->length = maxElts;
     sp->count = 0;
 
-    for (i = 0; i < maxElts; i ++)
-        sp->flags[i] = EMPTY;
-
+    STAT(memset(&sp->stats, 0, sizeof(sp->stats)));
     return sp;
 }
 
@@ -119,7 +526,7 @@ SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)())
 /*
  * Function:    destroySet
  *
- * Complexity:  O(m)
+ * Complexity:  O(1)
  *
  * Description: Deallocate memory associated with the set pointed to by SP.
  *		The elements themselves are not deallocated since we did not
@@ -131,8 +538,8 @@ void destroySet(SET *sp)
 {
     assert(sp != NULL);
 
-    free(sp->flags);
-    free(sp->data);
+    release(&sp->old);
+    release(&sp->cur);
     free(sp);
 }
 
@@ -157,23 +564,31 @@ int numElements(SET *sp)
  *
  * Complexity:  O(1) average case, O(n) worst case
  *
- * Description: Add ELT to the set pointed to by SP.
+ * Description: Add ELT to the set pointed to by SP.  The table is
+ *		expanded first if the insertion would overload it.
  */
 
 void addElement(SET *sp, void *elt)
 {
-    int locn;
+    int locn, dist;
+    unsigned h;
     bool found;
+    struct table *tp;
 
 
     assert(sp != NULL && elt != NULL);
-    locn = search(sp, elt, &found);
+    migrate(sp, MIGRATE);
+
+    h = hashElement(sp, elt);
+    locn = locate(sp, elt, h, &tp, &dist, &found);
 
     if (!found) {
-	assert(sp->count < sp->length);
+	if (overloaded(sp)) {
+	    expand(sp);
+	    locn = search(sp, &sp->cur, elt, h, &dist, &found);
+	}
 
-	sp->data[locn] = elt;
-	sp->flags[locn] = FILLED;
+	insert(&sp->cur, locn, elt, h, dist);
 	sp->count ++;
     }
 }
@@ -184,21 +599,30 @@ void addElement(SET *sp, void *elt)
  *
  * Complexity:  O(1) average case, O(n) worst case
  *
- * Description: Remove ELT from the set pointed to by SP.  A element is
- *		deleted by changing the state of its slot.
+ * Description: Remove ELT from the set pointed to by SP.  A element in the
+ *		current table is deleted by shifting the following elements
+ *		back.  A element in the old table is deleted by changing the
+ *		state of its slot, since shifting could move elements behind
+ *		the migration.
  */
 
 void removeElement(SET *sp, void *elt)
 {
-    int locn;
+    int locn, dist;
     bool found;
+    struct table *tp;
 
 
     assert(sp != NULL && elt != NULL);
-    locn = search(sp, elt, &found);
+    migrate(sp, MIGRATE);
+    locn = locate(sp, elt, hashElement(sp, elt), &tp, &dist, &found);
 
     if (found) {
-	sp->flags[locn] = DELETED;
+	if (tp == &sp->cur)
+	    delete(tp, locn);
+	else
+	    tp->flags[locn] = DELETED;
+
 	sp->count --;
     }
 }
@@ -215,81 +639,16 @@ void removeElement(SET *sp, void *elt)
 
 void *findElement(SET *sp, void *elt)
 {
-    int locn;
+    int locn, dist;
     bool found;
+    struct table *tp;
 
 
     assert(sp != NULL && elt != NULL);
 
-    locn = search(sp, elt, &found);
-    return found ? sp->data[locn] : NULL;
-}
-/*
-* Function: swap
-*
-* Complexity: O(1)
-*
-* Description: This function is a helper method that does swapping.
-*/
-static void swap(void **arr, int i1, int i2){
-    void *temp = arr[i1];
-    arr[i1] = arr[i2];
-    arr[i2] = temp;
-}
-/*
-* Function: parition
-* 
-* Complexity: O(n)
-* 
-* Description: This function partitions the array and makes sure each value is less than the pivot on the left or larger than the pivot
-* on the right. It then returns the index of the pivot for the quickSort_recurse to use.
-* The pivot point is selected randomly to reduce the amount of times the function runs in O(n^2) time.
-*/
-static int partition(void **arr, int (*compare)(), int lo, int hi){
-    int index = lo + rand() % (hi - lo);
-    if(index != hi){
-        swap(arr, index, hi);
-    }
-    void *pivot = arr[hi];
-    int i = lo;
-    for(int j = lo; j < hi; j++){
-        if(compare(arr[j], pivot) <= 0){
-            swap(arr, i, j);
-            i++;
-        }
-    }
-    swap(arr, i, hi);
-    return i;
+    locn = locate(sp, elt, hashElement(sp, elt), &tp, &dist, &found);
+    return found ? tp->data[locn] : NULL;
 }
-/*
-* Function:   quickSort_recurse
-*
-* Complexity: 
-*   Best/Avg Case: O(n log(n))
-*   Worst Case: O(n^2)   
-*
-* Description: This function does all the recursive quicksorting operations on the array. Since the pivot selection might be bad, 
-* the worst case is O(n^2).
-*/
-static void quickSort_recurse(void **arr, int (*compare)(), int lo, int hi){
-    if(lo < hi){
-        int pivot = partition(arr, compare, lo, hi);
-        quickSort_recurse(arr, compare, lo, pivot - 1);
-        quickSort_recurse(arr, compare, pivot + 1, hi);
-    }
-}
-/*
-* Function:   quickSort
-*
-* Complexity: O(1)
-*
-* Description: The basic quicksort function that initializes the recursive loop. Made to allow for a simpler input (len) instead of 
-* a hi and lo.
-*/
-static void quickSort(void **arr, int (*compare)(), int len){
-    srand(time(NULL));
-    quickSort_recurse(arr, compare, 0, len - 1);
-} 
 
 /*
  * Function:	getElements
@@ -311,9 +670,66 @@ void *getElements(SET *sp)
     elts = malloc(sizeof(void *) * sp->count);
     assert(elts != NULL);
 
-    for (i = 0, j = 0; i < sp->length; i ++)
-	if (sp->flags[i] == FILLED)
-	    elts[j ++] = sp->data[i];
-    quickSort(elts, sp -> compare, sp -> count);
+    for (i = 0, j = 0; i < sp->cur.length; i ++)
+	if (sp->cur.flags[i] == FILLED)
+	    elts[j ++] = sp->cur.data[i];
+
+    for (i = 0; i < sp->old.length; i ++)
+	if (sp->old.flags[i] == FILLED)
+	    elts[j ++] = sp->old.data[i];
+
+    sortElements(elts, sp->count, sp->compare);
     return elts;
 }
+
+
+/*
+ * Function:	maxProbeLength
+ *
+ * Complexity:	O(1)
+ *
+ * Description:	Return the longest probe sequence, counting the home slot,
+ *		needed by any element in the set pointed to by SP since the
+ *		table was last expanded.
+ */
+
+int maxProbeLength(SET *sp)
+{
+    assert(sp != NULL);
+
+    if (sp->old.maxProbe > sp->cur.maxProbe)
+	return sp->old.maxProbe;
+
+    return sp->cur.maxProbe;
+}
+
+
+# ifdef SETSTATS
+/*
+ * Function:	getSetStats
+ *
+ * Complexity:	O(m)
+ *
+ * Description:	Fill in OUT with the instrumentation counters of the set
+ *		pointed to by SP.  The deleted slots and the bytes held by
+ *		the tables are counted as of now.
+ */
+
+void getSetStats(SET *sp, struct setstats *out)
+{
+    int i;
+
+
+    assert(sp != NULL && out != NULL);
+
+    *out = sp->stats;
+    out->tombstones = 0;
+
+    for (i = 0; i < sp->old.length; i ++)
+	if (sp->old.flags[i] == DELETED)
+	    out->tombstones ++;
+
+    out->bytes = sizeof(SET) + (long) (sp->cur.length + sp->old.length) *
+	(sizeof(void *) + sizeof(unsigned) + sizeof(char));
+}
+# endif
@@ -5,11 +5,18 @@
 * Last Updated: 11/7/2024
 * Description: The implementation of the doubly linked circular linked list with a dummy node. Contains all the required
 interfacing functions for radix.c, maze.c, and table.c
+* Each list hands out its nodes from a slab of its own instead of calling malloc and free for every item. The slab is a chain of blocks
+aligned to a cache line, each one twice as big as the last up to MAX_NODES nodes. The first block holds just MIN_NODES nodes, so a short
+list like a bucket of a hash table takes a single cache line and an empty one takes none. A removed node goes on the list's free list, linked
+through its next pointer, and the next node added reuses it. All of the blocks are freed at once by destroyList.
 */
 #include <stdlib.h>
 #include <stdio.h>
 #include "list.h"
 #include <assert.h>
+#define LINE 64 //the # of bytes in a cache line
+#define MIN_NODES 2 //the # of nodes in the first block of a slab, which fills one cache line
+#define MAX_NODES 256 //the most nodes in any block of a slab
 /*
 * This is the struct for a node in the linked list that the list struct would use.
 * It contains the data that is stored in the node and a prev and next pointer as this is a doubly linked list.
@@ -20,15 +27,28 @@ struct node{
     struct node *prev;
 }; 
 /*
+* This is the header at the start of each block of a slab. The nodes of the block come right after it.
+*/
+struct block{
+    struct block *next;
+};
+/*
 * This is the list struct that defines all the data required for a list to be a list.
 *
 * It has a head pointer that will always point to the dummy node and also has a compare as this is a generic linked list 
 that works with any data type that is comparable.
+* The rest is the slab. free is the list of removed nodes, next and end are the part of the newest block that has not been handed out yet,
+blocks is the chain of every block, and size is the # of nodes to put in the next block.
 */
 typedef struct list{
     int count;
     struct node *head;
     int (*compare)();
+    struct node *free;
+    struct node *next;
+    struct node *end;
+    struct block *blocks;
+    int size;
 } LIST;
 /*
 * Big-O: O(1)
@@ -48,19 +68,61 @@ LIST *createList(int (*compare)()){
     lp -> head -> next = lp -> head;
     lp -> head -> prev = lp -> head;
     lp -> compare = compare;
+    lp -> free = NULL;
+    lp -> next = NULL;
+    lp -> end = NULL;
+    lp -> blocks = NULL;
+    lp -> size = MIN_NODES;
     return lp;
 }
 /*
+* Big-O: O(1)
+*
+* This function returns a node from the slab of the list. It takes the first node off the free list if there is one, and otherwise the next
+node of the newest block. When the newest block is used up, a new one is allocated that is aligned to a cache line and rounded up to a whole
+number of lines, which may leave room for a few more nodes than size.
+*/
+static struct node *allocNode(LIST *lp){
+    struct node *np = lp -> free;
+    if(np != NULL){
+        lp -> free = np -> next;
+        return np;
+    }
+    if(lp -> next == lp -> end){
+        size_t bytes = (sizeof(struct block) + sizeof(struct node) * lp -> size + LINE - 1) / LINE * LINE;
+        struct block *bp = aligned_alloc(LINE, bytes);
+        assert(bp != NULL);
+        bp -> next = lp -> blocks;
+        lp -> blocks = bp;
+        lp -> next = (struct node *) (bp + 1);
+        lp -> end = lp -> next + (bytes - sizeof(struct block)) / sizeof(struct node);
+        if(lp -> size < MAX_NODES){
+            lp -> size *= 2;
+        }
+    }
+    return lp -> next++;
+}
+/*
+* Big-O: O(1)
+*
+* This function gives the node np back to the slab of the list by pushing it onto the free list.
+*/
+static void freeNode(LIST *lp, struct node *np){
+    np -> next = lp -> free;
+    lp -> free = np;
+}
+/*
 * Big-O: O(n)
 *
-* This function goes through the entire list and frees each node and then ultimately frees the list pointer.
+* This function goes through the blocks of the slab and frees each one, which frees every node at once, and then ultimately frees the list pointer.
+* Since a block holds up to MAX_NODES nodes, there are far fewer blocks than nodes.
 */
 void destroyList(LIST *lp){
     assert(lp != NULL);
-    struct node *tbd = lp -> head -> next;
-    while(tbd != lp -> head){
-        struct node *del = tbd;
-        tbd = del -> next;
+    struct block *bp = lp -> blocks;
+    while(bp != NULL){
+        struct block *del = bp;
+        bp = del -> next;
         free(del);
     }
     free(lp -> head);
@@ -79,13 +141,13 @@ int numItems(LIST *lp){
 * Big-O: O(1)
 *
 * This function adds an element to the front of the linked list.
-* It allocates memory for the node and then sets all its variables.
+* It takes a node from the slab and then sets all its variables.
 * prev will always point to the dummy node and next will point to the element to the right of the dummy node (aka the first real node).
 */
 void addFirst(LIST *lp, void *item){
     assert(lp != NULL);
-    struct node *np = malloc(sizeof(struct node));
-    assert(np != NULL && item != NULL);
+    struct node *np = allocNode(lp);
+    assert(item != NULL);
     np -> data = item;
     np -> next = lp -> head -> next;
     np -> prev = lp -> head;
@@ -103,8 +165,8 @@ in the list that are modified.
 */
 void addLast(LIST *lp, void *item){
     assert(lp != NULL);
-    struct node *np = malloc(sizeof(struct node));
-    assert(np != NULL && item != NULL);
+    struct node *np = allocNode(lp);
+    assert(item != NULL);
     np -> data = item;
     np -> next = lp -> head;
     np -> prev = lp -> head -> prev;
@@ -116,7 +178,7 @@ void addLast(LIST *lp, void *item){
 * Big-O: O(1)
 *
 * This function removes the first element in the list and reconnects the other elements to one another.
-* The deleted node is then freed as we allocated memory to it when we added node in any of the addNode functions.
+* The deleted node is then given back to the slab that we took it from when we added node in any of the addNode functions.
 */
 void *removeFirst(LIST *lp){
     assert(lp != NULL);
@@ -127,14 +189,14 @@ void *removeFirst(LIST *lp){
     lp -> head -> next = del -> next;
     lp -> count--;
     void *data = del -> data;
-    free(del);
+    freeNode(lp, del);
     return data;
 }
 /*
 * Big-O: O(1)
 *
 * This function removes the last element in the list and reconnects the other elments to one another when the node is removed.
-* The deleted node is then freed as we allocated memory to it when we added node in any of the addNode functions.
+* The deleted node is then given back to the slab that we took it from when we added node in any of the addNode functions.
 */
 void *removeLast(LIST *lp){
     assert(lp != NULL);
@@ -145,7 +207,7 @@ void *removeLast(LIST *lp){
     lp -> head -> prev = del -> prev;
     lp -> count--;
     void *data = del -> data;
-    free(del);
+    freeNode(lp, del);
     return data;
 }
 /*
@@ -171,7 +233,7 @@ void *getLast(LIST *lp){
 *
 * Since we are only given the item (which is the data in a node), we need to search for it.
 * If the node is not found (aka when the del node pointer points to the head), you will not do any deletion.
-* If the node is found, it then goes through with the deletion process and frees the node to be deleted. 
+* If the node is found, it then goes through with the deletion process and gives the node to be deleted back to the slab. 
 */
 void removeItem(LIST *lp, void *item){
     assert(lp != NULL);
@@ -185,7 +247,7 @@ void removeItem(LIST *lp, void *item){
     if(del != lp -> head){
         del -> prev -> next = del -> next;
         del -> next -> prev = del -> prev;
-        free(del);
+        freeNode(lp, del);
     }
     lp -> count--;
 }
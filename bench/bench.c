@@ -0,0 +1,204 @@
+/*
+ * File:        bench.c
+ *
+ * Copyright:	2024, theonelog
+ *
+ * Description: This file contains the main function for a benchmark
+ *              runner for the set drivers.
+ *
+ *              Each program given with -p is run on each file given as an
+ *              argument, first WARMUP times untimed and then TRIALS times
+ *              timed.  One line of CSV is printed for each program and
+ *              file, giving the median and 99th percentile wall time, the
+ *              words processed per second at the median, and the peak
+ *              resident set size of the child.  The number of words is
+ *              read from the "total words" line the drivers print.
+ */
+
+# define _GNU_SOURCE
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <stdbool.h>
+# include <unistd.h>
+# include <time.h>
+# include <sys/types.h>
+# include <sys/time.h>
+# include <sys/resource.h>
+# include <sys/wait.h>
+
+# define MAX_PROGS 32
+
+
+/*
+ * Function:    now
+ *
+ * Description: Return the current time in seconds from a monotonic clock.
+ */
+
+static double now(void)
+{
+    struct timespec ts;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+/*
+ * Function:    run
+ *
+ * Description: Run PROG on FILE once.  The wall time is stored in *SECS,
+ *		the peak resident set size in kilobytes in *RSS, and the
+ *		number of words the driver reports in *WORDS.  Return false
+ *		if the program could not be run or did not exit cleanly.
+ */
+
+static bool run(char *prog, char *file, double *secs, long *rss, long *words)
+{
+    char buffer[BUFSIZ], *p;
+    struct rusage usage;
+    int fds[2], status, n, len;
+    double start;
+    pid_t pid;
+
+
+    *rss = 0;
+    *words = 0;
+
+    if (pipe(fds) == -1)
+	return false;
+
+    start = now();
+
+    if ((pid = fork()) == -1)
+	return false;
+
+    if (pid == 0) {
+	close(fds[0]);
+	dup2(fds[1], STDOUT_FILENO);
+	close(fds[1]);
+	execl(prog, prog, file, (char *) NULL);
+	_exit(127);
+    }
+
+    close(fds[1]);
+    len = 0;
+
+    while ((n = read(fds[0], buffer + len, sizeof(buffer) - 1 - len)) > 0)
+	if ((len += n) == sizeof(buffer) - 1)
+	    len = 0;
+
+    close(fds[0]);
+    buffer[len] = '\0';
+
+    if (wait4(pid, &status, 0, &usage) == -1)
+	return false;
+
+    *secs = now() - start;
+    *rss = usage.ru_maxrss;
+
+    if ((p = strstr(buffer, " total words")) != NULL) {
+	while (p > buffer && p[-1] >= '0' && p[-1] <= '9')
+	    p --;
+
+	*words = atol(p);
+    }
+
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+
+/*
+ * Function:    compare
+ *
+ * Description: Compare two times for qsort.
+ */
+
+static int compare(const void *a, const void *b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+
+
+    return x < y ? -1 : x > y;
+}
+
+
+/*
+ * Function:    main
+ *
+ * Description: Driver function for the benchmark runner.
+ */
+
+int main(int argc, char *argv[])
+{
+    char *progs[MAX_PROGS];
+    int i, j, k, c, nprogs, warmup, trials;
+    long rss, peak, words;
+    double *times;
+    bool ok;
+
+
+    /* Check usage. */
+
+    nprogs = 0;
+    warmup = 1;
+    trials = 5;
+
+    while ((c = getopt(argc, argv, "p:w:n:")) != -1)
+	if (c == 'p' && nprogs < MAX_PROGS)
+	    progs[nprogs ++] = optarg;
+	else if (c == 'w')
+	    warmup = atoi(optarg);
+	else if (c == 'n')
+	    trials = atoi(optarg);
+	else
+	    nprogs = -1;
+
+    if (nprogs <= 0 || optind == argc || warmup < 0 || trials < 1) {
+	fprintf(stderr, "usage: %s [-w warmup] [-n trials] -p program... file...\n", argv[0]);
+	exit(EXIT_FAILURE);
+    }
+
+    times = malloc(sizeof(double) * trials);
+
+    if (times == NULL) {
+	fprintf(stderr, "%s: out of memory\n", argv[0]);
+	exit(EXIT_FAILURE);
+    }
+
+
+    /* Time each program on each file. */
+
+    printf("program,corpus,trials,median_s,p99_s,ops_per_sec,peak_rss_kb\n");
+
+    for (i = 0; i < nprogs; i ++)
+	for (j = optind; j < argc; j ++) {
+	    ok = true;
+	    peak = 0;
+
+	    for (k = 0; ok && k < warmup + trials; k ++) {
+		ok = run(progs[i], argv[j], &times[k < warmup ? 0 : k - warmup], &rss, &words);
+
+		if (rss > peak)
+		    peak = rss;
+	    }
+
+	    if (!ok) {
+		fprintf(stderr, "%s: %s failed on %s\n", argv[0], progs[i], argv[j]);
+		continue;
+	    }
+
+	    qsort(times, trials, sizeof(double), compare);
+
+	    printf("%s,%s,%d,%.6f,%.6f,%.0f,%ld\n", progs[i], argv[j], trials,
+		times[trials / 2], times[(trials * 99 + 99) / 100 - 1],
+		words / times[trials / 2], peak);
+
+	    fflush(stdout);
+	}
+
+    free(times);
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,198 @@
+/*
+ * File:        arena.c
+ *
+ * Copyright:	2024, theonelog
+ *
+ * Description: This file contains the public and private function and type
+ *              definitions for an arena of strings.
+ *
+ *              Strings are copied into large chunks by bumping a pointer,
+ *              so short strings are packed next to each other and there is
+ *              no per-string allocator overhead.  Each copy is rounded up
+ *              to a multiple of ALIGN bytes, and the length rounded up
+ *              picks its size class.  A freed string is pushed onto the
+ *              free list of its size class, with the link stored in the
+ *              string itself, and the next copy of the same class reuses
+ *              it.  A string too long for any class gets a chunk of its
+ *              own.  The chunks are linked together and deallocated at
+ *              once by destroyArena.
+ */
+
+# include <stdlib.h>
+# include <string.h>
+# include <assert.h>
+# include "arena.h"
+
+# define ALIGN   8		/* granularity of a copy            */
+# define CLASSES 32		/* size classes, up to 256 bytes    */
+# define CHUNK   65536		/* bytes in an ordinary chunk       */
+
+struct chunk {
+    struct chunk *next;		/* next chunk allocated        */
+};
+
+struct arena {
+    char *next;			/* next free byte in chunk     */
+    char *end;			/* end of current chunk        */
+    struct chunk *chunks;	/* list of all chunks          */
+    char *free[CLASSES];	/* free list of each class     */
+    long bytes;			/* bytes allocated in chunks   */
+};
+
+
+/*
+ * Function:    allocate
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Allocate a chunk with room for SIZE bytes in the arena
+ *		pointed to by AP and return the first usable byte.
+ */
+
+static char *allocate(ARENA *ap, size_t size)
+{
+    struct chunk *cp;
+
+
+    cp = malloc(sizeof(struct chunk) + size);
+    assert(cp != NULL);
+
+    cp->next = ap->chunks;
+    ap->chunks = cp;
+    ap->bytes += sizeof(struct chunk) + size;
+
+    return (char *) (cp + 1);
+}
+
+
+/*
+ * Function:    createArena
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return a pointer to a new empty arena.
+ */
+
+ARENA *createArena(void)
+{
+    ARENA *ap;
+
+
+    ap = malloc(sizeof(ARENA));
+    assert(ap != NULL);
+
+    memset(ap, 0, sizeof(ARENA));
+    return ap;
+}
+
+
+/*
+ * Function:    destroyArena
+ *
+ * Complexity:  O(m)
+ *
+ * Description: Deallocate the arena pointed to by AP and every string in
+ *		it.
+ */
+
+void destroyArena(ARENA *ap)
+{
+    struct chunk *cp, *next;
+
+
+    assert(ap != NULL);
+
+    for (cp = ap->chunks; cp != NULL; cp = next) {
+	next = cp->next;
+	free(cp);
+    }
+
+    free(ap);
+}
+
+
+/*
+ * Function:    arenaCopy
+ *
+ * Complexity:  O(n)
+ *
+ * Description: Return a copy of the string S in the arena pointed to by
+ *		AP.
+ */
+
+char *arenaCopy(ARENA *ap, char *s)
+{
+    size_t length, size;
+    int class;
+    char *p;
+
+
+    assert(ap != NULL && s != NULL);
+
+    length = strlen(s) + 1;
+    size = (length + ALIGN - 1) / ALIGN * ALIGN;
+    class = size / ALIGN - 1;
+
+    if (class >= CLASSES)
+	p = allocate(ap, size);
+
+    else if (ap->free[class] != NULL) {
+	p = ap->free[class];
+	memcpy(&ap->free[class], p, sizeof(char *));
+
+    } else {
+	if (ap->end - ap->next < (long) size) {
+	    ap->next = allocate(ap, CHUNK);
+	    ap->end = ap->next + CHUNK;
+	}
+
+	p = ap->next;
+	ap->next += size;
+    }
+
+    memcpy(p, s, length);
+    return p;
+}
+
+
+/*
+ * Function:    arenaFree
+ *
+ * Complexity:  O(n)
+ *
+ * Description: Return the string S, which was copied into the arena
+ *		pointed to by AP, so that its space can be reused.  A string
+ *		too long for a size class is only deallocated along with the
+ *		arena.
+ */
+
+void arenaFree(ARENA *ap, char *s)
+{
+    int class;
+
+
+    assert(ap != NULL && s != NULL);
+
+    class = (strlen(s) + ALIGN) / ALIGN - 1;
+
+    if (class < CLASSES) {
+	memcpy(s, &ap->free[class], sizeof(char *));
+	ap->free[class] = s;
+    }
+}
+
+
+/*
+ * Function:    arenaBytes
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return the number of bytes the arena pointed to by AP has
+ *		allocated for its chunks.
+ */
+
+long arenaBytes(ARENA *ap)
+{
+    assert(ap != NULL);
+    return ap->bytes;
+}
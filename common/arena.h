@@ -0,0 +1,26 @@
+/*
+ * File:        arena.h
+ *
+ * Copyright:	2024, theonelog
+ *
+ * Description: This file contains the public function and type
+ *              declarations for an arena of strings.  All strings in an
+ *              arena are deallocated at once when the arena is destroyed.
+ */
+
+# ifndef ARENA_H
+# define ARENA_H
+
+typedef struct arena ARENA;
+
+ARENA *createArena(void);
+
+void destroyArena(ARENA *ap);
+
+char *arenaCopy(ARENA *ap, char *s);
+
+void arenaFree(ARENA *ap, char *s);
+
+long arenaBytes(ARENA *ap);
+
+# endif /* ARENA_H */
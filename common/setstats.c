@@ -0,0 +1,41 @@
+/*
+ * File:        setstats.c
+ *
+ * Copyright:	2024, theonelog
+ *
+ * Description: This file contains the public function definitions for the
+ *              instrumentation counters of a set.
+ */
+
+# include <stdio.h>
+# include "setstats.h"
+
+
+/*
+ * Function:    printSetStats
+ *
+ * Description: Print the instrumentation counters pointed to by ST on the
+ *		standard error, one per line as a name and a value.  Only
+ *		the buckets of the probe histogram that are not empty are
+ *		printed.
+ */
+
+void printSetStats(struct setstats *st)
+{
+    int i;
+
+
+    fprintf(stderr, "searches %ld\n", st->searches);
+    fprintf(stderr, "compares %ld\n", st->compares);
+    fprintf(stderr, "scanned %ld\n", st->scanned);
+    fprintf(stderr, "hashes %ld\n", st->hashes);
+    fprintf(stderr, "tombstones %ld\n", st->tombstones);
+    fprintf(stderr, "bytes %ld\n", st->bytes);
+    fprintf(stderr, "resizes %ld\n", st->resizes);
+    fprintf(stderr, "max probe %d\n", st->maxProbe);
+
+    for (i = 0; i < SETSTATS_BUCKETS; i ++)
+	if (st->probes[i] != 0)
+	    fprintf(stderr, "probes %d%s %ld\n", i,
+		i == SETSTATS_BUCKETS - 1 ? "+" : "", st->probes[i]);
+}
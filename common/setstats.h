@@ -0,0 +1,33 @@
+/*
+ * File:        setstats.h
+ *
+ * Copyright:	2024, theonelog
+ *
+ * Description: This file contains the public type and function
+ *              declarations for the instrumentation counters that the set
+ *              implementations keep when compiled with SETSTATS.  Every
+ *              implementation fills in the same structure, leaving any
+ *              counter that does not apply to it at zero.  The last bucket
+ *              of the probe histogram counts all longer searches too.
+ */
+
+# ifndef SETSTATS_H
+# define SETSTATS_H
+
+# define SETSTATS_BUCKETS 16
+
+struct setstats {
+    long searches;			/* number of searches made         */
+    long probes[SETSTATS_BUCKETS];	/* searches by probe length        */
+    long compares;			/* calls to the comparison function */
+    long scanned;			/* elements passed over by scans   */
+    long hashes;			/* calls to the hash function      */
+    long tombstones;			/* deleted slots still in the set  */
+    long bytes;				/* bytes allocated by the set      */
+    long resizes;			/* number of times the set resized */
+    int maxProbe;			/* longest probe length seen       */
+};
+
+void printSetStats(struct setstats *st);
+
+# endif /* SETSTATS_H */
@@ -0,0 +1,418 @@
+/*
+ * File:        tokens.c
+ *
+ * Copyright:	2024, theonelog
+ *
+ * Description: This file contains the public and private function and type
+ *              definitions for a tokenizer that splits a file into words
+ *              separated by white space.
+ *
+ *              A regular file is mapped into memory privately and each
+ *              word is returned as a pointer into the mapping, so no word
+ *              is copied.  The white space character after a word is
+ *              overwritten with a null character so that the word can be
+ *              used as a string.  Since the mapping is private, the file
+ *              itself is never changed.  Anything that cannot be mapped,
+ *              such as a pipe, is read into memory instead.
+ *
+ *              Words can also be counted without being split out.  The
+ *              contents are classified 64 bytes at a time using AVX2 when
+ *              the processor has it and SSE2 otherwise, giving a bit mask
+ *              of the white space characters.  A word starts wherever a
+ *              clear bit follows a set bit, so the words in a block are
+ *              the population count of a couple of mask operations.
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <assert.h>
+# include <stdbool.h>
+# include <unistd.h>
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include "tokens.h"
+
+# ifdef __SSE2__
+# include <immintrin.h>
+# endif
+
+# define SPACE(c) ((c) == ' ' || ((c) >= '\t' && (c) <= '\r'))
+# define BLOCK 64		/* bytes classified at once        */
+
+struct tokens {
+    char *data;			/* contents of the file        */
+    char *next;			/* next character to scan      */
+    char *end;			/* end of the contents         */
+    size_t mapped;		/* length mapped, or zero      */
+    char *last;			/* copy of an unterminated word */
+};
+
+
+/*
+ * Function:    slurp
+ *
+ * Complexity:  O(n)
+ *
+ * Description: Read the remainder of the file FD into memory for the
+ *		tokenizer pointed to by TP, leaving room for a null character
+ *		after the last word.  Return false on a read error.
+ */
+
+static bool slurp(TOKENS *tp, int fd)
+{
+    size_t length, size;
+    ssize_t n;
+
+
+    length = 0;
+    size = BUFSIZ;
+    tp->data = malloc(size);
+    assert(tp->data != NULL);
+
+    while ((n = read(fd, tp->data + length, size - length - 1)) > 0)
+	if ((length += n) == size - 1) {
+	    size *= 2;
+	    tp->data = realloc(tp->data, size);
+	    assert(tp->data != NULL);
+	}
+
+    if (n < 0) {
+	free(tp->data);
+	return false;
+    }
+
+    tp->end = tp->data + length;
+    return true;
+}
+
+
+/*
+ * Function:    openTokens
+ *
+ * Complexity:  O(1) if mapped, O(n) if read
+ *
+ * Description: Return a pointer to a new tokenizer for the file named
+ *		PATH, or NULL if the file cannot be opened or read.
+ */
+
+TOKENS *openTokens(char *path)
+{
+    struct stat st;
+    TOKENS *tp;
+    void *data;
+    int fd;
+
+
+    assert(path != NULL);
+
+    if ((fd = open(path, O_RDONLY)) == -1)
+	return NULL;
+
+    tp = malloc(sizeof(TOKENS));
+    assert(tp != NULL);
+
+    tp->mapped = 0;
+    tp->last = NULL;
+
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+	data = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+	if (data != MAP_FAILED) {
+	    madvise(data, st.st_size, MADV_SEQUENTIAL);
+	    tp->mapped = st.st_size;
+	    tp->data = data;
+	    tp->end = tp->data + tp->mapped;
+	}
+    }
+
+    if (tp->mapped == 0 && !slurp(tp, fd)) {
+	close(fd);
+	free(tp);
+	return NULL;
+    }
+
+    close(fd);
+    tp->next = tp->data;
+    return tp;
+}
+
+
+/*
+ * Function:    closeTokens
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Deallocate memory associated with the tokenizer pointed to
+ *		by TP.  Any words it returned are no longer valid.
+ */
+
+void closeTokens(TOKENS *tp)
+{
+    assert(tp != NULL);
+
+    if (tp->mapped != 0)
+	munmap(tp->data, tp->mapped);
+    else
+	free(tp->data);
+
+    free(tp->last);
+    free(tp);
+}
+
+
+/*
+ * Function:    nextToken
+ *
+ * Complexity:  O(m)
+ *
+ * Description: Return the next word of the tokenizer pointed to by TP as
+ *		a null-terminated string, storing its length in *LEN if LEN
+ *		is not NULL.  Return NULL when there are no more words.  The
+ *		byte past the end of a mapping can only be written if it is
+ *		in the same page, so a final word that fills its last page
+ *		is copied instead.
+ */
+
+char *nextToken(TOKENS *tp, int *len)
+{
+    char *p, *start;
+
+
+    assert(tp != NULL);
+
+    for (p = tp->next; p < tp->end && SPACE(*p); p ++)
+	;
+
+    if (p == tp->end) {
+	tp->next = p;
+	return NULL;
+    }
+
+    for (start = p; p < tp->end && !SPACE(*p); p ++)
+	;
+
+    if (len != NULL)
+	*len = p - start;
+
+    if (p < tp->end) {
+	*p = '\0';
+	tp->next = p + 1;
+	return start;
+    }
+
+    tp->next = p;
+
+    if (tp->mapped == 0 || tp->mapped % sysconf(_SC_PAGESIZE) != 0) {
+	*p = '\0';
+	return start;
+    }
+
+    tp->last = malloc(p - start + 1);
+    assert(tp->last != NULL);
+
+    memcpy(tp->last, start, p - start);
+    tp->last[p - start] = '\0';
+    return tp->last;
+}
+
+
+/*
+ * Function:    tokenData
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return the contents of the tokenizer pointed to by TP that
+ *		have not yet been split into words, storing their length in
+ *		*LENGTH.
+ */
+
+char *tokenData(TOKENS *tp, size_t *length)
+{
+    assert(tp != NULL && length != NULL);
+
+    *length = tp->end - tp->next;
+    return tp->next;
+}
+
+
+# ifndef __SSE2__
+/*
+ * Function:    countBlocks
+ *
+ * Complexity:  O(n)
+ *
+ * Description: Return the number of words that start in the N blocks of
+ *		BLOCK bytes starting at DATA, one bit at a time.  *CARRY is
+ *		1 if the byte before DATA is white space, and on return is 1
+ *		if the last byte is white space.
+ */
+
+static long countBlocks(const char *data, size_t n, unsigned long long *carry)
+{
+    unsigned long long mask;
+    long count;
+    int i;
+
+
+    for (count = 0; n > 0; n --, data += BLOCK) {
+	for (mask = 0, i = BLOCK - 1; i >= 0; i --)
+	    mask = mask << 1 | SPACE(data[i]);
+
+	count += __builtin_popcountll(~mask & (mask << 1 | *carry));
+	*carry = mask >> (BLOCK - 1);
+    }
+
+    return count;
+}
+# endif
+
+
+# ifdef __SSE2__
+/*
+ * Function:    classify16
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return a bit mask of the white space characters in the 16
+ *		bytes starting at P.  Subtracting a tab moves the other white
+ *		space characters to 0 through 4, and a byte is at most 4
+ *		exactly when the unsigned minimum of it and 4 is itself.
+ */
+
+static inline unsigned classify16(const char *p)
+{
+    __m128i bytes, low;
+
+
+    bytes = _mm_loadu_si128((const __m128i *) p);
+    low = _mm_sub_epi8(bytes, _mm_set1_epi8('\t'));
+    low = _mm_cmpeq_epi8(_mm_min_epu8(low, _mm_set1_epi8(4)), low);
+
+    return _mm_movemask_epi8(_mm_or_si128(low,
+	_mm_cmpeq_epi8(bytes, _mm_set1_epi8(' '))));
+}
+
+
+/*
+ * Function:    countBlocksSSE2
+ *
+ * Complexity:  O(n)
+ *
+ * Description: Count words as in countBlocks, classifying each block with
+ *		four SSE2 comparisons.
+ */
+
+static long countBlocksSSE2(const char *data, size_t n, unsigned long long *carry)
+{
+    unsigned long long mask;
+    long count;
+
+
+    for (count = 0; n > 0; n --, data += BLOCK) {
+	mask = (unsigned long long) classify16(data) |
+	    (unsigned long long) classify16(data + 16) << 16 |
+	    (unsigned long long) classify16(data + 32) << 32 |
+	    (unsigned long long) classify16(data + 48) << 48;
+
+	count += __builtin_popcountll(~mask & (mask << 1 | *carry));
+	*carry = mask >> (BLOCK - 1);
+    }
+
+    return count;
+}
+
+
+/*
+ * Function:    classify32
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return a bit mask of the white space characters in the 32
+ *		bytes starting at P, as in classify16.
+ */
+
+__attribute__((target("avx2")))
+static inline unsigned classify32(const char *p)
+{
+    __m256i bytes, low;
+
+
+    bytes = _mm256_loadu_si256((const __m256i *) p);
+    low = _mm256_sub_epi8(bytes, _mm256_set1_epi8('\t'));
+    low = _mm256_cmpeq_epi8(_mm256_min_epu8(low, _mm256_set1_epi8(4)), low);
+
+    return _mm256_movemask_epi8(_mm256_or_si256(low,
+	_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' '))));
+}
+
+
+/*
+ * Function:    countBlocksAVX2
+ *
+ * Complexity:  O(n)
+ *
+ * Description: Count words as in countBlocks, classifying each block with
+ *		two AVX2 comparisons.
+ */
+
+__attribute__((target("avx2,popcnt")))
+static long countBlocksAVX2(const char *data, size_t n, unsigned long long *carry)
+{
+    unsigned long long mask;
+    long count;
+
+
+    for (count = 0; n > 0; n --, data += BLOCK) {
+	mask = (unsigned long long) classify32(data) |
+	    (unsigned long long) classify32(data + 32) << 32;
+
+	count += __builtin_popcountll(~mask & (mask << 1 | *carry));
+	*carry = mask >> (BLOCK - 1);
+    }
+
+    return count;
+}
+# endif
+
+
+/*
+ * Function:    countWords
+ *
+ * Complexity:  O(n)
+ *
+ * Description: Return the number of words that start in the LENGTH bytes
+ *		starting at DATA.  SPACE is true if the byte before DATA is
+ *		white space or if there is no such byte, so that a word that
+ *		runs into DATA from before it is not counted twice.
+ */
+
+long countWords(const char *data, size_t length, bool space)
+{
+    unsigned long long carry;
+    size_t i, n;
+    long count;
+
+
+    carry = space;
+    n = length / BLOCK;
+
+# ifdef __SSE2__
+    if (__builtin_cpu_supports("avx2"))
+	count = countBlocksAVX2(data, n, &carry);
+    else
+	count = countBlocksSSE2(data, n, &carry);
+# else
+    count = countBlocks(data, n, &carry);
+# endif
+
+    for (space = carry, i = n * BLOCK; i < length; i ++) {
+	if (space && !SPACE(data[i]))
+	    count ++;
+
+	space = SPACE(data[i]);
+    }
+
+    return count;
+}
@@ -0,0 +1,30 @@
+/*
+ * File:        tokens.h
+ *
+ * Copyright:	2024, theonelog
+ *
+ * Description: This file contains the public function and type
+ *              declarations for a tokenizer that splits a file into words
+ *              separated by white space, as fscanf's "%s" does, and for
+ *              counting such words without splitting them out.
+ */
+
+# ifndef TOKENS_H
+# define TOKENS_H
+
+# include <stddef.h>
+# include <stdbool.h>
+
+typedef struct tokens TOKENS;
+
+TOKENS *openTokens(char *path);
+
+void closeTokens(TOKENS *tp);
+
+char *nextToken(TOKENS *tp, int *len);
+
+char *tokenData(TOKENS *tp, size_t *length);
+
+long countWords(const char *data, size_t length, bool space);
+
+# endif /* TOKENS_H */